@@ -0,0 +1,87 @@
+#include "CommandBuffer.h"
+
+#include "../../../Debug.h"
+
+namespace BWAPI
+{
+  static_assert(CommandBuffer::FRAME_SLOTS >= BW::Latency::BattlenetHigh + 16,
+                "The command buffer must keep every frame that is predicted at the highest latency");
+
+  //----------------------------------------------- CONSTRUCTOR ----------------------------------------------
+  CommandBuffer::CommandBuffer()
+  {
+    this->clear();
+  }
+  //-------------------------------------------------- CLEAR -------------------------------------------------
+  void CommandBuffer::clear()
+  {
+    for ( int i = 0; i < FRAME_SLOTS; ++i )
+      slots[i].clear();
+    currentSlot   = 0;
+    frameCount    = 1;
+    bufferedCount = 0;
+    replayedCount = 0;
+  }
+  //--------------------------------------------------- ADD --------------------------------------------------
+  void CommandBuffer::add(const UnitCommand &command)
+  {
+    Command c(command);
+    c.execute(0);
+
+    // Queued commands are never predicted, there is no need to keep them
+    if ( !c.isActive(0) )
+      return;
+    slots[currentSlot].push_back(c);
+    ++bufferedCount;
+  }
+  //------------------------------------------------- REPLAY -------------------------------------------------
+  void CommandBuffer::replay(int latency)
+  {
+    // Drop the oldest frames to make room for the new one. The ring holds every frame for the
+    // latencies Broodwar uses, the limit only guards against other values.
+    int maxFrames = latency + 16;
+    if ( maxFrames > FRAME_SLOTS )
+      maxFrames = FRAME_SLOTS;
+    while ( frameCount >= maxFrames )
+    {
+      std::vector<Command> &oldest = slots[(currentSlot - frameCount + 1 + FRAME_SLOTS) % FRAME_SLOTS];
+      bufferedCount -= oldest.size();
+      oldest.clear();
+      --frameCount;
+    }
+    currentSlot = (currentSlot + 1) % FRAME_SLOTS;
+    ++frameCount;
+
+    // Apply the older frames first, the new frame is still empty
+    replayedCount = 0;
+    for ( int age = frameCount - 1; age > 0; --age )
+    {
+      std::vector<Command> &slot = slots[(currentSlot - age + FRAME_SLOTS) % FRAME_SLOTS];
+
+      // Keep the order of the commands that still have an effect, and drop the others for good
+      size_t kept = 0;
+      for ( size_t i = 0; i < slot.size(); ++i )
+      {
+        if ( !slot[i].isActive(age) )
+          continue;
+        slot[i].execute(age);
+        ++replayedCount;
+        if ( kept != i )
+          slot[kept] = slot[i];
+        ++kept;
+      }
+      bufferedCount -= slot.size() - kept;
+      slot.erase(slot.begin() + kept, slot.end());
+    }
+  }
+  //-------------------------------------------- GET BUFFERED COUNT ------------------------------------------
+  int CommandBuffer::getBufferedCount() const
+  {
+    return bufferedCount;
+  }
+  //-------------------------------------------- GET REPLAYED COUNT ------------------------------------------
+  int CommandBuffer::getReplayedCount() const
+  {
+    return replayedCount;
+  }
+};
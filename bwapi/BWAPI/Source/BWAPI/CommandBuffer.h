@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include <BWAPI/UnitCommand.h>
+#include <BW/Latency.h>
+
+#include "Command.h"
+
+namespace BWAPI
+{
+  /**
+   * Keeps the unit commands issued during the last frames, so that their effects can be predicted
+   * until Broodwar carries them out. Frames are kept in a fixed ring of slots that reuse their
+   * storage, so buffering a command does not allocate once the slots have grown.
+   */
+  class CommandBuffer
+  {
+    public :
+      /** Number of frames the ring can hold, enough for the highest latency plus the 15 extra
+       * frames that some commands are predicted for. */
+      static const int FRAME_SLOTS = BW::Latency::BattlenetHigh + 16;
+
+      CommandBuffer();
+
+      /** Forgets all commands, called at the end of a match. */
+      void clear();
+
+      /** Predicts the effects of a command issued this frame, and keeps it to predict them again
+       * in the next frames. */
+      void add(const UnitCommand &command);
+
+      /** Starts a new frame, and applies the commands of the previous frames again on top of the
+       * unit data that was just read from Broodwar. Commands whose effects have become visible in
+       * the game are dropped. */
+      void replay(int latency);
+
+      /** Retrieves the number of commands that are kept in the buffer. */
+      int getBufferedCount() const;
+
+      /** Retrieves the number of commands that the last replay applied. */
+      int getReplayedCount() const;
+    private :
+      std::vector<Command> slots[FRAME_SLOTS];
+      int currentSlot;    // slot of the current frame
+      int frameCount;     // frames in the ring, including the current one
+      int bufferedCount;
+      int replayedCount;
+  };
+};
@@ -15,6 +15,7 @@ namespace BWAPI
   public :
     CommandTemp(UnitCommand command);
     void execute(int frame);
+    bool isActive(int frame) const;
   protected:
     virtual ~CommandTemp() {};
   private :
@@ -39,10 +40,36 @@ namespace BWAPI
     return unit->getID();
   }
   template <class UnitImpl, class PlayerImpl>
+  bool CommandTemp<UnitImpl, PlayerImpl>::isActive(int frame) const
+  {
+    // Queued commands are not predicted
+    if ( command.isQueued() )
+      return false;
+
+    // Latency test, once the latency has passed only a few commands still need predicting
+    if ( frame <= Broodwar->getLatency() )
+      return true;
+    switch ( command.type )
+    {
+    case UnitCommandTypes::Enum::Cancel_Construction:
+    case UnitCommandTypes::Enum::Cancel_Train_Slot:
+    case UnitCommandTypes::Enum::Cancel_Morph:
+    case UnitCommandTypes::Enum::Train:
+    case UnitCommandTypes::Enum::Gather:
+    case UnitCommandTypes::Enum::Stop:
+    case UnitCommandTypes::Enum::Return_Cargo:
+    case UnitCommandTypes::Enum::Right_Click_Position:
+    case UnitCommandTypes::Enum::Morph:
+      return true;
+    default:
+      return false;
+    }
+  }
+  template <class UnitImpl, class PlayerImpl>
   void CommandTemp<UnitImpl, PlayerImpl>::execute(int frame)
   {
-    // Immediately return if latency compensation is disabled or if the command was queued
-    if ( !Broodwar->isLatComEnabled() || command.isQueued() ) return;
+    // Immediately return if latency compensation is disabled or if the command has no effect
+    if ( !Broodwar->isLatComEnabled() || !isActive(frame) ) return;
     UnitImpl* unit   = static_cast<UnitImpl*>(command.unit);
     UnitImpl* target = static_cast<UnitImpl*>(command.target);
 
@@ -56,19 +83,6 @@ namespace BWAPI
     if ( !player )
       player = static_cast<PlayerImpl*>(unit ? unit->getPlayer() : Broodwar->self());
 
-    // Latency test
-    if (frame > Broodwar->getLatency() &&
-        command.type != UnitCommandTypes::Cancel_Construction &&
-        command.type != UnitCommandTypes::Cancel_Train_Slot &&
-        command.type != UnitCommandTypes::Cancel_Morph &&
-        command.type != UnitCommandTypes::Train &&
-        command.type != UnitCommandTypes::Gather &&
-        command.type != UnitCommandTypes::Stop &&
-        command.type != UnitCommandTypes::Return_Cargo &&
-        command.type != UnitCommandTypes::Right_Click_Position &&
-        command.type != UnitCommandTypes::Morph)
-      return;
-
     // Existence test
     switch ( command.type )
     {
@@ -12,26 +12,16 @@
 namespace BWAPI
 {
   //----------------------------------------- ADD TO COMMAND BUFFER ------------------------------------------
-  void GameImpl::addToCommandBuffer(Command* command)
+  void GameImpl::addToCommandBuffer(const UnitCommand &command)
   {
-    //executes latency compensation code and added it to the buffer
-    command->execute(0);
-    this->commandBuffer[this->commandBuffer.size() - 1].push_back(command);
+    //executes latency compensation code and adds it to the buffer
+    this->commandBuffer.add(command);
   }
   //----------------------------------------- APPLY LATENCY COMPENSATION
   void GameImpl::applyLatencyCompensation()
   {
     //apply latency compensation
-    while ((int)(this->commandBuffer.size()) > this->getLatency()+15)
-    {
-      for (unsigned int i = 0; i < this->commandBuffer.front().size(); ++i)
-        delete this->commandBuffer.front()[i];
-      this->commandBuffer.erase(this->commandBuffer.begin());
-    }
-    this->commandBuffer.push_back(std::vector<Command *>());
-    for (unsigned int i = 0; i < this->commandBuffer.size(); ++i)
-      for (unsigned int j = 0; j < this->commandBuffer[i].size(); ++j)
-        this->commandBuffer[i][j]->execute(this->commandBuffer.size()-1-i);
+    this->commandBuffer.replay(this->getLatency());
   }
 
   //------------------------------------------- ADD TO CMD OPTIMIZER -----------------------------------------
@@ -182,10 +172,33 @@ namespace BWAPI
     // Set last immediate command again in case it was altered when inserting it into the optimizer
     static_cast<UnitImpl*>(command.unit)->setLastImmediateCommand(command);
 
-    // Add command to the command optimizer buffer and unload it later (newest commands first)
-    commandOptimizer[command.getType().getID()].push_front(command);
+    // Add command to the bucket of equal commands in the command optimizer buffer and unload it
+    // later (newest commands first)
+    CommandOptimizerKey key = { command.type, command.target, command.x, command.y, command.extra };
+    auto bucket = commandOptimizerBuckets.find(key);
+    if ( bucket == commandOptimizerBuckets.end() )
+    {
+      if ( commandOptimizerBucketCount == commandOptimizer.size() )
+        commandOptimizer.push_back(std::vector<UnitCommand>());
+      bucket = commandOptimizerBuckets.insert(std::make_pair(key, commandOptimizerBucketCount++)).first;
+    }
+    commandOptimizer[bucket->second].push_back(command);
     return true;
   }
+  //------------------------------------------ COMMAND OPTIMIZER KEY -----------------------------------------
+  bool GameImpl::CommandOptimizerKey::operator ==(const CommandOptimizerKey &other) const
+  {
+    return type == other.type && target == other.target && x == other.x && y == other.y && extra == other.extra;
+  }
+  size_t GameImpl::CommandOptimizerKeyHash::operator()(const CommandOptimizerKey &key) const
+  {
+    size_t h = std::hash<Unit>()(key.target);
+    h = h*31 + key.type;
+    h = h*31 + key.x;
+    h = h*31 + key.y;
+    h = h*31 + key.extra;
+    return h;
+  }
   //--------------------------------------------- EXECUTE COMMAND --------------------------------------------
   void GameImpl::executeCommand(UnitCommand command)
   {
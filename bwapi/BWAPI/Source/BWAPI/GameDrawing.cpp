@@ -15,6 +15,9 @@ namespace BWAPI
   //-------------------------------------------------- IN SCREEN ---------------------------------------------
   bool GameImpl::inScreen(CoordinateType::Enum ctype, int x, int y)
   {
+    // Draw lists are kept for the whole match, wherever the screen is now
+    if ( recordingDrawList )
+      return true;
     if ( !data->hasGUI )
       return false;
 
@@ -40,6 +43,8 @@ namespace BWAPI
 
   bool GameImpl::inScreen(CoordinateType::Enum ctype, int x1, int y1, int x2, int y2)
   {
+    if ( recordingDrawList )
+      return true;
     if ( !data->hasGUI )
       return false;
 
@@ -80,6 +85,8 @@ namespace BWAPI
 
   bool GameImpl::inScreen(CoordinateType::Enum ctype, int x1, int y1, int x2, int y2, int x3, int y3)
   {
+    if ( recordingDrawList )
+      return true;
     if ( !data->hasGUI )
       return false;
 
@@ -122,21 +129,100 @@ namespace BWAPI
   }
   int GameImpl::addShape(const BWAPIC::Shape &s)
   {
+    if ( recordingDrawList )
+    {
+      recordingDrawList->shapes.push_back(s);
+      return (int)recordingDrawList->shapes.size() - 1;
+    }
     assert(data->shapeCount < GameData::MAX_SHAPES);
     data->shapes[data->shapeCount] = s;
     return data->shapeCount++;
   }
-  int GameImpl::addString(const char* text)
-  {
-    assert(data->stringCount < GameData::MAX_STRINGS);
-    StrCopy(data->strings[data->stringCount], text);
-    return data->stringCount++;
-  }
   int GameImpl::addText(BWAPIC::Shape &s, const char* text)
   {
-    s.extra1 = addString(text);
+    if ( recordingDrawList )
+    {
+      s.extra1 = (int)recordingDrawList->texts.size();
+      recordingDrawList->texts.push_back(text);
+      return addShape(s);
+    }
+    // Overlays draw the same labels over and over, store each one once per frame
+    s.extra1 = textInterner.add(data->strings, text);
+    assert(s.extra1 != -1);
     return addShape(s);
   }
+  //-------------------------------------------------- DRAW LISTS --------------------------------------------
+  int GameImpl::createDrawList(const char *name)
+  {
+    for ( size_t i = 0; i < drawLists.size(); ++i )
+    {
+      if ( drawLists[i].name == name )
+        return (int)i;
+    }
+    drawLists.push_back(DrawList());
+    drawLists.back().name = name;
+    return (int)drawLists.size() - 1;
+  }
+  void GameImpl::beginDrawList(int list)
+  {
+    endDrawList();
+    if ( list < 0 || list >= (int)drawLists.size() )
+      return;
+    drawLists[list].clear();
+    recordingDrawList = &drawLists[list];
+  }
+  void GameImpl::endDrawList()
+  {
+    recordingDrawList = nullptr;
+  }
+  void GameImpl::clearDrawList(int list)
+  {
+    if ( list < 0 || list >= (int)drawLists.size() )
+      return;
+    drawLists[list].clear();
+  }
+  void GameImpl::resetClientDrawList(int list, const char *name)
+  {
+    // The client numbers its lists itself, gaps are left empty
+    if ( list < 0 || list >= GameData::MAX_DRAW_LISTS )
+      return;
+    if ( list >= (int)clientDrawLists.size() )
+      clientDrawLists.resize(list + 1);
+    clientDrawLists[list].name = name;
+    clientDrawLists[list].clear();
+  }
+  void GameImpl::setClientDrawListShapes(int list, const BWAPIC::Shape *shapes, int count)
+  {
+    if ( list < 0 || list >= (int)clientDrawLists.size() )
+      return;
+    clientDrawLists[list].clear();
+    recordingDrawList = &clientDrawLists[list];
+    for ( int i = 0; i < count; ++i )
+    {
+      BWAPIC::Shape s = shapes[i];
+      if ( s.type == BWAPIC::ShapeType::Text )
+        addText(s, data->strings.get(s.extra1));
+      else
+        addShape(s);
+    }
+    recordingDrawList = nullptr;
+  }
+  void GameImpl::clearClientDrawList(int list)
+  {
+    if ( list < 0 || list >= (int)clientDrawLists.size() )
+      return;
+    clientDrawLists[list].clear();
+  }
+  void GameImpl::clearClientDrawLists()
+  {
+    clientDrawLists.clear();
+  }
+  void GameImpl::clearDrawLists()
+  {
+    drawLists.clear();
+    clientDrawLists.clear();
+    recordingDrawList = nullptr;
+  }
   //-------------------------------------------------- DRAW TEXT ---------------------------------------------
   void GameImpl::setTextSize(Text::Size::Enum size)
   {
@@ -150,7 +236,7 @@ namespace BWAPI
   }
   void GameImpl::vDrawText(CoordinateType::Enum ctype, int x, int y, const char *format, va_list arg)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && !recordingDrawList ) return;
     char buffer[512];
     VSNPrintf(buffer, format, arg);
     BWAPIC::Shape s(BWAPIC::ShapeType::Text,ctype,x,y,0,0,0,textSize,0,false);
@@ -215,286 +301,306 @@ namespace BWAPI
   //--------------------------------------------- DRAW SHAPES ------------------------------------------------
   int GameImpl::drawShapes()
   {
+    int count = data->shapeCount;
     for ( int i = 0; i < data->shapeCount; i++ )
     {
-      BWAPIC::ShapeType::Enum s = data->shapes[i].type;
-      int x1 = data->shapes[i].x1;
-      int y1 = data->shapes[i].y1;
-      int x2, y2, x3, y3, ly, ry, w, h, lx, rx, dx1, dx2, dx3;
-      int radius, f, ddF_x, ddF_y, xi, yi;
-      int xrad, yrad, a2, b2, crit1, crit2, crit3, t, dxt, dyt, d2xt, d2yt, twoAsquare, twoBsquare, xchange, ychange, ellipseerror, stoppingX, stoppingY;
-      CoordinateType::Enum ctype = data->shapes[i].ctype;
-      bool isSolid = data->shapes[i].isSolid;
-      BWAPI::Color color = Color(data->shapes[i].color);
-      switch ( s )
-      {
-        case BWAPIC::ShapeType::Text:
-           bwDrawText(x1,y1,data->strings[data->shapes[i].extra1],ctype,(char)data->shapes[i].extra2);
-           break;
-        case BWAPIC::ShapeType::Box:
-          x2 = data->shapes[i].x2;
-          y2 = data->shapes[i].y2;
-          w = abs(x2 - x1);
-          h = abs(y2 - y1);
-          if (isSolid)
+      const BWAPIC::Shape &shape = data->shapes[i];
+      drawShape(shape, shape.type == BWAPIC::ShapeType::Text ? data->strings.get(shape.extra1) : nullptr);
+    }
+    count += drawListShapes(drawLists);
+    count += drawListShapes(clientDrawLists);
+    return count;
+  }
+  int GameImpl::drawListShapes(const std::deque<DrawList> &lists)
+  {
+    int count = 0;
+    for ( auto list = lists.begin(); list != lists.end(); ++list )
+    {
+      for ( auto shape = list->shapes.begin(); shape != list->shapes.end(); ++shape )
+        drawShape(*shape, shape->type == BWAPIC::ShapeType::Text ? list->texts[shape->extra1].c_str() : nullptr);
+      count += (int)list->shapes.size();
+    }
+    return count;
+  }
+  //---------------------------------------------- DRAW SHAPE ------------------------------------------------
+  void GameImpl::drawShape(const BWAPIC::Shape &shape, const char *text)
+  {
+    BWAPIC::ShapeType::Enum s = shape.type;
+    int x1 = shape.x1;
+    int y1 = shape.y1;
+    int x2, y2, x3, y3, ly, ry, w, h, lx, rx, dx1, dx2, dx3;
+    int radius, f, ddF_x, ddF_y, xi, yi;
+    int xrad, yrad, a2, b2, crit1, crit2, crit3, t, dxt, dyt, d2xt, d2yt, twoAsquare, twoBsquare, xchange, ychange, ellipseerror, stoppingX, stoppingY;
+    CoordinateType::Enum ctype = shape.ctype;
+    bool isSolid = shape.isSolid;
+    BWAPI::Color color = Color(shape.color);
+    switch ( s )
+    {
+      case BWAPIC::ShapeType::Text:
+         bwDrawText(x1,y1,text,ctype,(char)shape.extra2);
+         break;
+      case BWAPIC::ShapeType::Box:
+        x2 = shape.x2;
+        y2 = shape.y2;
+        w = abs(x2 - x1);
+        h = abs(y2 - y1);
+        if (isSolid)
+        {
+          bwDrawBox(x1, y1, w, h, color, ctype);
+        }
+        else
+        {
+          bwDrawBox(  x1,   y1, 1, h, color, ctype);
+          bwDrawBox(  x1,   y1, w, 1, color, ctype);
+          bwDrawBox(x2-1,   y1, 1, h, color, ctype);
+          bwDrawBox(  x1, y2-1, w, 1, color, ctype);
+        }
+        break;
+      case BWAPIC::ShapeType::Triangle:
+        x2 = shape.x2;
+        y2 = shape.y2;
+        x3 = shape.extra1;
+        y3 = shape.extra2;
+        if(isSolid)
+        {
+          if(y1 > y2) { std::swap(x1, x2); std::swap(y1, y2); }
+          if(y1 > y3) { std::swap(x1, x3); std::swap(y1, y3); }
+          if(y2 > y3) { std::swap(x2, x3); std::swap(y2, y3); }
+
+          if (y2 - y1 > 0) dx1 = int2Fixed(x2 - x1) / (y2 - y1); else dx1 = int2Fixed(x2 - x1);
+          if (y3 - y1 > 0) dx2 = int2Fixed(x3 - x1) / (y3 - y1); else dx2 = 0;
+          if (y3 - y2 > 0) dx3 = int2Fixed(x3 - x2) / (y3 - y2); else dx3 = 0;
+
+          rx = lx = int2Fixed(x1);
+          ry = ly = y1;
+          if(dx1 > dx2)
           {
-            bwDrawBox(x1, y1, w, h, color, ctype);
+            for(; ly <= y2; ly++, ry++, lx += dx2, rx += dx1)
+              bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
+            rx = int2Fixed(x2); ry = y2;
+            for(; ly <= y3; ly++, ry++, lx += dx2, rx += dx3)
+              bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
           }
           else
           {
-            bwDrawBox(  x1,   y1, 1, h, color, ctype);
-            bwDrawBox(  x1,   y1, w, 1, color, ctype);
-            bwDrawBox(x2-1,   y1, 1, h, color, ctype);
-            bwDrawBox(  x1, y2-1, w, 1, color, ctype);
+            for(; ly <= y2; ly++, ry++, lx += dx1, rx += dx2)
+              bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
+            lx = int2Fixed(x2); ly = y2;
+            for(; ly <= y3; ly++, ry++, lx += dx3, rx += dx2)
+              bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
           }
-          break;
-        case BWAPIC::ShapeType::Triangle:
-          x2 = data->shapes[i].x2;
-          y2 = data->shapes[i].y2;
-          x3 = data->shapes[i].extra1;
-          y3 = data->shapes[i].extra2;
-          if(isSolid)
-          {
-            if(y1 > y2) { std::swap(x1, x2); std::swap(y1, y2); }
-            if(y1 > y3) { std::swap(x1, x3); std::swap(y1, y3); }
-            if(y2 > y3) { std::swap(x2, x3); std::swap(y2, y3); }
+        }
+        else
+        {
+          bwDrawLine(x1, y1, x2, y2, color, ctype);
+          bwDrawLine(x1, y1, x3, y3, color, ctype);
+          bwDrawLine(x2, y2, x3, y3, color, ctype);
+        }
+        break;
+      case BWAPIC::ShapeType::Circle:
+        radius = shape.extra1;
+        if (isSolid)
+        {
+          f = 1 - radius;
+          ddF_x = 1;
+          ddF_y = -2 * radius;
+          xi = 0;
+          yi = radius;
 
-            if (y2 - y1 > 0) dx1 = int2Fixed(x2 - x1) / (y2 - y1); else dx1 = int2Fixed(x2 - x1);
-            if (y3 - y1 > 0) dx2 = int2Fixed(x3 - x1) / (y3 - y1); else dx2 = 0;
-            if (y3 - y2 > 0) dx3 = int2Fixed(x3 - x2) / (y3 - y2); else dx3 = 0;
+          bwDrawDot(x1, y1 + radius, color, ctype);
+          bwDrawDot(x1, y1 - radius, color, ctype);
+          bwDrawBox(x1 - radius, y1, radius*2, 1, color, ctype);
 
-            rx = lx = int2Fixed(x1);
-            ry = ly = y1;
-            if(dx1 > dx2)
-            {
-              for(; ly <= y2; ly++, ry++, lx += dx2, rx += dx1)
-                bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
-              rx = int2Fixed(x2); ry = y2;
-              for(; ly <= y3; ly++, ry++, lx += dx2, rx += dx3)
-                bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
-            }
-            else
+          while(xi < yi)
+          {
+            if(f >= 0)
             {
-              for(; ly <= y2; ly++, ry++, lx += dx1, rx += dx2)
-                bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
-              lx = int2Fixed(x2); ly = y2;
-              for(; ly <= y3; ly++, ry++, lx += dx3, rx += dx2)
-                bwDrawBox(fixed2Int(lx), ly, positive(fixed2Int(rx) - fixed2Int(lx)), 1, color, ctype);
+              yi--;
+              ddF_y += 2;
+              f += ddF_y;
             }
+            xi++;
+            ddF_x += 2;
+            f += ddF_x;
+            bwDrawBox(x1 - xi, y1 - yi, xi*2 + 1, 1, color, ctype);
+            bwDrawBox(x1 - xi, y1 + yi, xi*2 + 1, 1, color, ctype);
+            bwDrawBox(x1 - yi, y1 - xi, yi*2 + 1, 1, color, ctype);
+            bwDrawBox(x1 - yi, y1 + xi, yi*2 + 1, 1, color, ctype);
           }
-          else
-          {
-            bwDrawLine(x1, y1, x2, y2, color, ctype);
-            bwDrawLine(x1, y1, x3, y3, color, ctype);
-            bwDrawLine(x2, y2, x3, y3, color, ctype);
-          }
-          break;
-        case BWAPIC::ShapeType::Circle:
-          radius = data->shapes[i].extra1;
-          if (isSolid)
-          {
-            f = 1 - radius;
-            ddF_x = 1;
-            ddF_y = -2 * radius;
-            xi = 0;
-            yi = radius;
+        }
+        else
+        {
+          f = 1 - radius;
+          ddF_x = 1;
+          ddF_y = -2 * radius;
+          xi = 0;
+          yi = radius;
 
-            bwDrawDot(x1, y1 + radius, color, ctype);
-            bwDrawDot(x1, y1 - radius, color, ctype);
-            bwDrawBox(x1 - radius, y1, radius*2, 1, color, ctype);
+          bwDrawDot(x1, y1 + radius, color, ctype);
+          bwDrawDot(x1, y1 - radius, color, ctype);
+          bwDrawDot(x1 + radius, y1, color, ctype);
+          bwDrawDot(x1 - radius, y1, color, ctype);
 
-            while(xi < yi)
+          while(xi < yi)
+          {
+            if(f >= 0)
             {
-              if(f >= 0)
-              {
-                yi--;
-                ddF_y += 2;
-                f += ddF_y;
-              }
-              xi++;
-              ddF_x += 2;
-              f += ddF_x;
-              bwDrawBox(x1 - xi, y1 - yi, xi*2 + 1, 1, color, ctype);
-              bwDrawBox(x1 - xi, y1 + yi, xi*2 + 1, 1, color, ctype);
-              bwDrawBox(x1 - yi, y1 - xi, yi*2 + 1, 1, color, ctype);
-              bwDrawBox(x1 - yi, y1 + xi, yi*2 + 1, 1, color, ctype);
+              yi--;
+              ddF_y += 2;
+              f += ddF_y;
             }
+            xi++;
+            ddF_x += 2;
+            f += ddF_x;
+            bwDrawDot(x1 + xi, y1 + yi, color, ctype);
+            bwDrawDot(x1 - xi, y1 + yi, color, ctype);
+            bwDrawDot(x1 + xi, y1 - yi, color, ctype);
+            bwDrawDot(x1 - xi, y1 - yi, color, ctype);
+            bwDrawDot(x1 + yi, y1 + xi, color, ctype);
+            bwDrawDot(x1 - yi, y1 + xi, color, ctype);
+            bwDrawDot(x1 + yi, y1 - xi, color, ctype);
+            bwDrawDot(x1 - yi, y1 - xi, color, ctype);
           }
-          else
+        }
+        break;
+      case BWAPIC::ShapeType::Ellipse:
+        xrad = shape.extra1;
+        yrad = shape.extra2;
+        if (xrad != 0 && yrad != 0)
+        {
+          if (isSolid)
           {
-            f = 1 - radius;
-            ddF_x = 1;
-            ddF_y = -2 * radius;
-            xi = 0;
-            yi = radius;
-
-            bwDrawDot(x1, y1 + radius, color, ctype);
-            bwDrawDot(x1, y1 - radius, color, ctype);
-            bwDrawDot(x1 + radius, y1, color, ctype);
-            bwDrawDot(x1 - radius, y1, color, ctype);
+            x2 = 0, y2 = yrad;
+            w = 1;
+            a2 = xrad * xrad;
+            b2 = yrad * yrad;
+            crit1 = -(a2 / 4 + xrad % 2 + b2);
+            crit2 = -(b2 / 4 + yrad % 2 + a2);
+            crit3 = -(b2 / 4 + yrad % 2);
+            t = - a2 * y2;
+            dxt = 2 * b2 * x2;
+            dyt = -2 * a2 * y2;
+            d2xt = 2 * b2;
+            d2yt = 2 * a2;
 
-            while(xi < yi)
+            while (y2 >= 0 && x2 <= xrad)
             {
-              if(f >= 0)
+              if (t + b2*x2 <= crit1 ||
+                  t + a2*y2 <= crit3)
               {
-                yi--;
-                ddF_y += 2;
-                f += ddF_y;
+                incx();
+                w += 2;
+              }
+              else if (t - a2*y2 > crit2)
+              {
+                bwDrawBox(x1 - x2, y1 - y2, w, 1, color, ctype);
+                if (y2 != 0)
+                  bwDrawBox(x1 - x2, y1 + y2, w, 1, color, ctype);
+                incy();
+              }
+              else
+              {
+                bwDrawBox(x1 - x2, y1 - y2, w, 1, color, ctype);
+                if (y2 != 0)
+                  bwDrawBox(x1 - x2, y1 + y2, w, 1, color, ctype);
+                incx();
+                incy();
+                w += 2;
               }
-              xi++;
-              ddF_x += 2;
-              f += ddF_x;
-              bwDrawDot(x1 + xi, y1 + yi, color, ctype);
-              bwDrawDot(x1 - xi, y1 + yi, color, ctype);
-              bwDrawDot(x1 + xi, y1 - yi, color, ctype);
-              bwDrawDot(x1 - xi, y1 - yi, color, ctype);
-              bwDrawDot(x1 + yi, y1 + xi, color, ctype);
-              bwDrawDot(x1 - yi, y1 + xi, color, ctype);
-              bwDrawDot(x1 + yi, y1 - xi, color, ctype);
-              bwDrawDot(x1 - yi, y1 - xi, color, ctype);
             }
+            if (yrad == 0)
+              bwDrawBox(x1 - xrad, y1, 2*xrad + 1, 1, color, ctype);
           }
-          break;
-        case BWAPIC::ShapeType::Ellipse:
-          xrad = data->shapes[i].extra1;
-          yrad = data->shapes[i].extra2;
-          if (xrad != 0 && yrad != 0)
+          else
           {
-            if (isSolid)
+            x2 = xrad;
+            y2 = 0;
+            twoAsquare = 2 * xrad * xrad;
+            twoBsquare = 2 * yrad * yrad;
+            xchange = yrad * yrad * (1 - 2 * xrad);
+            ychange = xrad * xrad;
+            ellipseerror = 0;
+            stoppingX = twoBsquare * xrad;
+            stoppingY = 0;
+
+            while (stoppingX >= stoppingY)
             {
-              x2 = 0, y2 = yrad;
-              w = 1;
-              a2 = xrad * xrad;
-              b2 = yrad * yrad;
-              crit1 = -(a2 / 4 + xrad % 2 + b2);
-              crit2 = -(b2 / 4 + yrad % 2 + a2);
-              crit3 = -(b2 / 4 + yrad % 2);
-              t = - a2 * y2;
-              dxt = 2 * b2 * x2;
-              dyt = -2 * a2 * y2;
-              d2xt = 2 * b2;
-              d2yt = 2 * a2;
+              bwDrawDot(x1 + x2, y1 + y2, color, ctype);
+              bwDrawDot(x1 - x2, y1 + y2, color, ctype);
+              bwDrawDot(x1 - x2, y1 - y2, color, ctype);
+              bwDrawDot(x1 + x2, y1 - y2, color, ctype);
 
-              while (y2 >= 0 && x2 <= xrad)
+              y2++;
+              stoppingY += twoAsquare;
+              ellipseerror += ychange;
+              ychange += twoAsquare;
+              if ((2 * ellipseerror + xchange) > 0)
               {
-                if (t + b2*x2 <= crit1 ||
-                    t + a2*y2 <= crit3)
-                {
-                  incx();
-                  w += 2;
-                }
-                else if (t - a2*y2 > crit2)
-                {
-                  bwDrawBox(x1 - x2, y1 - y2, w, 1, color, ctype);
-                  if (y2 != 0)
-                    bwDrawBox(x1 - x2, y1 + y2, w, 1, color, ctype);
-                  incy();
-                }
-                else
-                {
-                  bwDrawBox(x1 - x2, y1 - y2, w, 1, color, ctype);
-                  if (y2 != 0)
-                    bwDrawBox(x1 - x2, y1 + y2, w, 1, color, ctype);
-                  incx();
-                  incy();
-                  w += 2;
-                }
+                x2--;
+                stoppingX -= twoBsquare;
+                ellipseerror += xchange;
+                xchange += twoBsquare;
               }
-              if (yrad == 0)
-                bwDrawBox(x1 - xrad, y1, 2*xrad + 1, 1, color, ctype);
             }
-            else
+            x2 = 0;
+            y2 = yrad;
+            xchange = yrad * yrad;
+            ychange = xrad * xrad * (1 - 2 * yrad);
+            ellipseerror = 0;
+            stoppingX = 0;
+            stoppingY = twoAsquare * yrad;
+            while (stoppingX <= stoppingY)
             {
-              x2 = xrad;
-              y2 = 0;
-              twoAsquare = 2 * xrad * xrad;
-              twoBsquare = 2 * yrad * yrad;
-              xchange = yrad * yrad * (1 - 2 * xrad);
-              ychange = xrad * xrad;
-              ellipseerror = 0;
-              stoppingX = twoBsquare * xrad;
-              stoppingY = 0;
 
-              while (stoppingX >= stoppingY)
-              {
-                bwDrawDot(x1 + x2, y1 + y2, color, ctype);
-                bwDrawDot(x1 - x2, y1 + y2, color, ctype);
-                bwDrawDot(x1 - x2, y1 - y2, color, ctype);
-                bwDrawDot(x1 + x2, y1 - y2, color, ctype);
+              bwDrawDot(x1 + x2, y1 + y2, color, ctype);
+              bwDrawDot(x1 - x2, y1 + y2, color, ctype);
+              bwDrawDot(x1 - x2, y1 - y2, color, ctype);
+              bwDrawDot(x1 + x2, y1 - y2, color, ctype);
 
-                y2++;
-                stoppingY += twoAsquare;
+              x2++;
+              stoppingX += twoBsquare;
+              ellipseerror += xchange;
+              xchange += twoBsquare;
+              if ((2 * ellipseerror + ychange) > 0)
+              {
+                y2--;
+                stoppingY -= twoAsquare;
                 ellipseerror += ychange;
                 ychange += twoAsquare;
-                if ((2 * ellipseerror + xchange) > 0)
-                {
-                  x2--;
-                  stoppingX -= twoBsquare;
-                  ellipseerror += xchange;
-                  xchange += twoBsquare;
-                }
-              }
-              x2 = 0;
-              y2 = yrad;
-              xchange = yrad * yrad;
-              ychange = xrad * xrad * (1 - 2 * yrad);
-              ellipseerror = 0;
-              stoppingX = 0;
-              stoppingY = twoAsquare * yrad;
-              while (stoppingX <= stoppingY)
-              {
-
-                bwDrawDot(x1 + x2, y1 + y2, color, ctype);
-                bwDrawDot(x1 - x2, y1 + y2, color, ctype);
-                bwDrawDot(x1 - x2, y1 - y2, color, ctype);
-                bwDrawDot(x1 + x2, y1 - y2, color, ctype);
-
-                x2++;
-                stoppingX += twoBsquare;
-                ellipseerror += xchange;
-                xchange += twoBsquare;
-                if ((2 * ellipseerror + ychange) > 0)
-                {
-                  y2--;
-                  stoppingY -= twoAsquare;
-                  ellipseerror += ychange;
-                  ychange += twoAsquare;
-                }
               }
             }
           }
-          else if ( xrad == 0 && yrad == 0)
-          {
-            bwDrawDot(x1, y1, color, ctype);
-          }
-          else if ( xrad == 0)
-          {
-            bwDrawBox(x1, y1 - yrad, 1, yrad*2, color, ctype);
-          }
-          else //if ( yrad == 0)
-          {
-            bwDrawBox(x1 - xrad, y1, xrad*2, 1, color, ctype);
-          }
-          break;
-        case BWAPIC::ShapeType::Dot:
+        }
+        else if ( xrad == 0 && yrad == 0)
+        {
           bwDrawDot(x1, y1, color, ctype);
-          break;
-        case BWAPIC::ShapeType::Line:
-          x2 = data->shapes[i].x2;
-          y2 = data->shapes[i].y2;
-          if ( x1 == x2 && y1 == y2 )
-            bwDrawDot(x1, y1, color, ctype);
-          else if ( x1 == x2 )
-            bwDrawBox(x1, y1 < y2 ? y1 : y2, 1, abs(y2 - y1), color, ctype);
-          else if ( y1 == y2 )
-            bwDrawBox(x1 < x2 ? x1 : x2, y1, abs(x2 - x1), 1, color, ctype);
-          else
-            bwDrawLine(x1, y1, x2, y2, color, ctype);
-          break;
-        default:
-          break;
-      }
+        }
+        else if ( xrad == 0)
+        {
+          bwDrawBox(x1, y1 - yrad, 1, yrad*2, color, ctype);
+        }
+        else //if ( yrad == 0)
+        {
+          bwDrawBox(x1 - xrad, y1, xrad*2, 1, color, ctype);
+        }
+        break;
+      case BWAPIC::ShapeType::Dot:
+        bwDrawDot(x1, y1, color, ctype);
+        break;
+      case BWAPIC::ShapeType::Line:
+        x2 = shape.x2;
+        y2 = shape.y2;
+        if ( x1 == x2 && y1 == y2 )
+          bwDrawDot(x1, y1, color, ctype);
+        else if ( x1 == x2 )
+          bwDrawBox(x1, y1 < y2 ? y1 : y2, 1, abs(y2 - y1), color, ctype);
+        else if ( y1 == y2 )
+          bwDrawBox(x1 < x2 ? x1 : x2, y1, abs(x2 - x1), 1, color, ctype);
+        else
+          bwDrawLine(x1, y1, x2, y2, color, ctype);
+        break;
+      default:
+        break;
     }
-    return data->shapeCount;
   }
 };
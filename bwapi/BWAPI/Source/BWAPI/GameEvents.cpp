@@ -28,9 +28,10 @@ namespace BWAPI
     this->onStartCalled   = true;
     this->calledMatchEnd  = false;
 
-    // load the map data
-    map.load();
+    // load the map data, from the map cache if this map was played before
     this->savedMapHash = Map::getMapHash();
+    bool isMapCached = mapCache.open(savedMapHash, Map::getWidth(), Map::getHeight());
+    map.load(mapCache.getData());
 
     // Obtain Broodwar Regions
     if ( *BW::BWDATA::SAIPathing )
@@ -44,6 +45,22 @@ namespace BWAPI
       foreach ( BWAPI::RegionImpl *r, this->regionsList )
         r->UpdateRegionRelations();
     } // if SAI_Pathing
+    this->_computeRegionNeighbors();
+
+    // Compute the clearance of each mini-tile from the walkability, and save the static map data
+    // for the next match on this map
+    if ( isMapCached )
+    {
+      const MapCacheData *cache = mapCache.getData();
+      this->clearance.assign(cache->clearance, cache->clearance + Map::getWidth()*4*Map::getHeight()*4);
+    }
+    else
+    {
+      this->_computeClearance();
+      this->_saveMapCache();
+    }
+    this->placementMap.reset(Map::getWidth(), Map::getHeight());
+    this->powerGrid.reset(Map::getWidth(), Map::getHeight());
 
     // roughly identify which players can possibly participate in this game
     // iterate triggers for each player
@@ -278,20 +278,43 @@ namespace BWAPI
   {
     return this->unitArray[index-1];
   }
+  // Uses the unit grid once updateUnits has built it for the current frame, and Broodwar's unit finder otherwise
+  template <typename F>
+  static void iterateUnitsInRectangle(const UnitGrid &grid, int left, int top, int right, int bottom, const F &callback)
+  {
+    if ( grid.isValid() )
+      grid.iterateRectangle(left, top, right, bottom, callback);
+    else
+      Templates::iterateUnitFinder<BW::unitFinder>(BW::BWDATA::UnitOrderingX,
+                                                   BW::BWDATA::UnitOrderingY,
+                                                   *BW::BWDATA::UnitOrderingCount,
+                                                   left,
+                                                   top,
+                                                   right,
+                                                   bottom,
+                                                   callback);
+  }
+  void GameImpl::visitUnitsInRectangle(int left, int top, int right, int bottom, UnitVisitor visit, const void *context) const
+  {
+    iterateUnitsInRectangle(unitGrid,
+                            left,
+                            top,
+                            right,
+                            bottom,
+                            [&](Unit u){ visit(context, u); });
+  }
   Unitset GameImpl::getUnitsInRectangle(int left, int top, int right, int bottom, const UnitFilter &pred) const
   {
     Unitset unitFinderResults;
 
     // Have the unit finder do its stuff
-    Templates::iterateUnitFinder<BW::unitFinder>(BW::BWDATA::UnitOrderingX,
-                                                 BW::BWDATA::UnitOrderingY,
-                                                 *BW::BWDATA::UnitOrderingCount,
-                                                 left,
-                                                 top,
-                                                 right,
-                                                 bottom,
-                                                 [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                                 unitFinderResults.push_back(u); });
+    iterateUnitsInRectangle(unitGrid,
+                            left,
+                            top,
+                            right,
+                            bottom,
+                            [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                            unitFinderResults.push_back(u); });
     // Return results
     return unitFinderResults;
   }
@@ -300,22 +323,20 @@ namespace BWAPI
     int bestDistance = 99999999;
     Unit pBestUnit = nullptr;
 
-    Templates::iterateUnitFinder<BW::unitFinder>( BW::BWDATA::UnitOrderingX,
-                                                  BW::BWDATA::UnitOrderingY,
-                                                  *BW::BWDATA::UnitOrderingCount,
-                                                  left,
-                                                  top,
-                                                  right,
-                                                  bottom,
-                                                  [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                                {
-                                                                  int newDistance = u->getDistance(center);
-                                                                  if ( newDistance < bestDistance )
-                                                                  {
-                                                                    pBestUnit = u;
-                                                                    bestDistance = newDistance;
-                                                                  }
-                                                                } } );
+    iterateUnitsInRectangle(unitGrid,
+                            left,
+                            top,
+                            right,
+                            bottom,
+                            [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                          {
+                                            int newDistance = u->getDistance(center);
+                                            if ( newDistance < bestDistance )
+                                            {
+                                              pBestUnit = u;
+                                              bestDistance = newDistance;
+                                            }
+                                          } } );
     return pBestUnit;
   }
   Unit GameImpl::getBestUnit(const BestUnitFilter &best, const UnitFilter &pred, Position center, int radius) const
@@ -329,20 +350,18 @@ namespace BWAPI
     topLeft.makeValid();
     botRight.makeValid();
 
-    Templates::iterateUnitFinder<BW::unitFinder>( BW::BWDATA::UnitOrderingX,
-                                                  BW::BWDATA::UnitOrderingY,
-                                                  *BW::BWDATA::UnitOrderingCount,
-                                                  topLeft.x,
-                                                  topLeft.y,
-                                                  botRight.x,
-                                                  botRight.y,
-                                                  [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                                {
-                                                                  if ( pBestUnit == nullptr )
-                                                                    pBestUnit = u;
-                                                                  else
-                                                                    pBestUnit = best(pBestUnit,u); 
-                                                                } } );
+    iterateUnitsInRectangle(unitGrid,
+                            topLeft.x,
+                            topLeft.y,
+                            botRight.x,
+                            botRight.y,
+                            [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                          {
+                                            if ( pBestUnit == nullptr )
+                                              pBestUnit = u;
+                                            else
+                                              pBestUnit = best(pBestUnit,u); 
+                                          } } );
 
     return pBestUnit;
   }
@@ -414,10 +433,66 @@ namespace BWAPI
       return false;
     return map.hasCreep(x, y);
   }
+  //--------------------------------------------- CLIP TILE RECT ---------------------------------------------
+  // Clips a tile rectangle to the map, returns false if nothing is left of it
+  static bool clipTileRect(const Game *game, int &left, int &top, int &right, int &bottom)
+  {
+    if ( left < 0 )
+      left = 0;
+    if ( top < 0 )
+      top = 0;
+    if ( right >= game->mapWidth() )
+      right = game->mapWidth() - 1;
+    if ( bottom >= game->mapHeight() )
+      bottom = game->mapHeight() - 1;
+    return left <= right && top <= bottom;
+  }
+  //--------------------------------------------- IS ANY VISIBLE ---------------------------------------------
+  bool GameImpl::isAnyVisible(int left, int top, int right, int bottom) const
+  {
+    clipTileRect(this, left, top, right, bottom);
+    for ( int y = top; y <= bottom; ++y )
+      for ( int x = left; x <= right; ++x )
+      {
+        if ( this->isVisible(x, y) )
+          return true;
+      }
+    return false;
+  }
+  //--------------------------------------------- IS ALL EXPLORED --------------------------------------------
+  bool GameImpl::isAllExplored(int left, int top, int right, int bottom) const
+  {
+    if ( !clipTileRect(this, left, top, right, bottom) )
+      return false;
+    for ( int y = top; y <= bottom; ++y )
+      for ( int x = left; x <= right; ++x )
+      {
+        if ( !this->isExplored(x, y) )
+          return false;
+      }
+    return true;
+  }
+  //--------------------------------------------- HAS ANY CREEP ----------------------------------------------
+  bool GameImpl::hasAnyCreep(int left, int top, int right, int bottom) const
+  {
+    clipTileRect(this, left, top, right, bottom);
+    for ( int y = top; y <= bottom; ++y )
+      for ( int x = left; x <= right; ++x )
+      {
+        if ( this->hasCreep(x, y) )
+          return true;
+      }
+    return false;
+  }
+  //-------------------------------------------- GET CHANGED TILES -------------------------------------------
+  bool GameImpl::getChangedTiles(std::vector<TilePosition> &tiles, int layers) const
+  {
+    return map.getTileChanges().getTiles(layers, this->mapWidth(), this->mapHeight(), tiles);
+  }
   //--------------------------------------------- HAS POWER --------------------------------------------------
   bool GameImpl::hasPowerPrecise(int x, int y, UnitType unitType) const
   {
-    return Templates::hasPower(x, y, unitType, pylons);
+    return Templates::hasPower(x, y, unitType, powerGrid);
   }
   //------------------------------------------------- PRINTF -------------------------------------------------
   void GameImpl::vPrintf(const char *format, va_list arg)
@@ -728,6 +803,8 @@ namespace BWAPI
         botAPM_select++;
         QueueGameCommand(&sel, sel.size);
       }
+      else
+        commandOptimizerSavedSelects[commandOptimizerLevel]++;
 
       // Execute the command
       BroodwarImpl.executeCommand( command );
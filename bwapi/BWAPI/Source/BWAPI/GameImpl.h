@@ -1,13 +1,22 @@
 #pragma once
 #include <string>
 #include <list>
+#include <deque>
+#include <unordered_map>
 
 #include <BW/Offsets.h>
 
 #include <BWAPI/Game.h>
 #include <BWAPI/Server.h>
 #include <BWAPI/Map.h>
+#include <BWAPI/MapCache.h>
+#include <BWAPI/CommandBuffer.h>
 #include <BWAPI/Client/GameData.h>
+#include <BWAPI/Client/StaticGameData.h>
+#include <BWAPI/Client/UnitGrid.h>
+#include <BWAPI/Client/PlacementMap.h>
+#include <BWAPI/Client/PowerGrid.h>
+#include <BWAPI/IndexedUnitset.h>
 #include <BWAPI/TournamentAction.h>
 #include <BWAPI/CoordinateType.h>
 
@@ -25,7 +34,6 @@ namespace BWAPI
 {
   // forwards
   class AIModule;
-  class Command;
   class BulletImpl;
   class Bulletset;
   
@@ -81,6 +89,7 @@ namespace BWAPI
       virtual bool    isFlagEnabled(int flag) const override;
       virtual void    enableFlag(int flag) override;
 
+      virtual void visitUnitsInRectangle(int left, int top, int right, int bottom, UnitVisitor visit, const void *context) const override;
       virtual Unitset getUnitsInRectangle(int left, int top, int right, int bottom, const UnitFilter &pred = nullptr) const override;
       virtual Unit getClosestUnitInRectangle(Position center, const UnitFilter &pred = nullptr, int left = 0, int top = 0, int right = 999999, int bottom = 999999) const override;
       virtual Unit getBestUnit(const BestUnitFilter &best, const UnitFilter &pred, Position center = Positions::None, int radius = 999999) const override;
@@ -101,6 +110,10 @@ namespace BWAPI
       virtual bool  isVisible(int x, int y) const override;
       virtual bool  isExplored(int x, int y) const override;
       virtual bool  hasCreep(int x, int y) const override;
+      virtual bool  isAnyVisible(int left, int top, int right, int bottom) const override;
+      virtual bool  isAllExplored(int left, int top, int right, int bottom) const override;
+      virtual bool  hasAnyCreep(int left, int top, int right, int bottom) const override;
+      virtual bool  getChangedTiles(std::vector<TilePosition> &tiles, int layers = TileChange::All) const override;
       virtual bool  hasPowerPrecise(int x, int y, UnitType unitType = UnitTypes::None ) const override;
 
       virtual bool  canBuildHere(TilePosition position, UnitType type, Unit builder = nullptr, bool checkExplored = false) override;
@@ -143,6 +156,11 @@ namespace BWAPI
       virtual void drawDot(CoordinateType::Enum ctype, int x, int y, Color color) override;
       virtual void drawLine(CoordinateType::Enum ctype, int x1, int y1, int x2, int y2, Color color) override;
 
+      virtual int  createDrawList(const char *name) override;
+      virtual void beginDrawList(int list) override;
+      virtual void endDrawList() override;
+      virtual void clearDrawList(int list) override;
+
       virtual int getLatencyFrames() const override;
       virtual int getLatencyTime() const override;
       virtual int getRemainingLatencyFrames() const override;
@@ -162,6 +180,7 @@ namespace BWAPI
       virtual void setFrameSkip(int frameSkip) override;
 
       virtual bool hasPath(Position source, Position destination) const override;
+      virtual bool hasPath(Position source, Position destination, UnitSizeType size) const override;
 
       virtual bool setAlliance(Player player, bool allied = true, bool alliedVictory = true) override;
       virtual bool setVision(Player player, bool enabled = true) override;
@@ -172,6 +191,10 @@ namespace BWAPI
 
       virtual const Regionset &getAllRegions() const override;
       virtual BWAPI::Region   getRegionAt(int x, int y) const override;
+      virtual int             getGroundDistance(BWAPI::Region source, BWAPI::Region destination) const override;
+      virtual int             getClearance(int x, int y) const override;
+      using Game::getClearance;
+      using Game::getGroundDistance;
 
       virtual int getLastEventTime() const override;
 
@@ -201,7 +224,7 @@ namespace BWAPI
       void mouseDown(int x, int y);
       void mouseUp(int x, int y);
 
-      void addToCommandBuffer(Command* command);
+      void addToCommandBuffer(const UnitCommand &command);
       void onGameStart();
       void onGameEnd();
       int  stormIdToPlayerId(int dwStormId);
@@ -236,6 +259,12 @@ namespace BWAPI
       std::list<std::string > sentMessages;
       void onSaveGame(char *name);
       std::list<Event> events;
+      MapCache mapCache;
+
+      // Region adjacency in compressed rows, the neighbors of region i are the IDs in
+      // regionNeighbors from regionNeighborOffsets[i] up to regionNeighborOffsets[i+1]
+      std::vector<int> regionNeighborOffsets;
+      std::vector<unsigned short> regionNeighbors;
       int bulletCount;
       Server server;
       Unitset lastEvadedUnits;
@@ -261,13 +290,26 @@ namespace BWAPI
       UnitImpl *unitArray[UNIT_ARRAY_MAX_LENGTH];
       bool isTournamentCall;
       const GameData* getGameData() const;
+      const StaticGameData* getStaticGameData() const;
       GameData* data;
+      StaticGameData* staticData;
       
       int drawShapes();
+      /** Creates the client's draw list with the given handle, or renames and empties it. Client
+       * lists are kept apart from the lists of the modules in this process. */
+      void resetClientDrawList(int list, const char *name);
+      /** Replaces the contents of a client's draw list with shapes it has written to the GameData. */
+      void setClientDrawListShapes(int list, const BWAPIC::Shape *shapes, int count);
+      void clearClientDrawList(int list);
+      void clearClientDrawLists();
+      void clearDrawLists();
       void processEvents();
       Unit _unitFromIndex(int index);
+      unsigned int *_beginUnitFinder(unsigned int &markBase);
+      void _endUnitFinder();
 
       int  commandOptimizerLevel;
+      unsigned int commandOptimizerSavedSelects[5]; // select packets saved at each optimizer level
 
       HMODULE hAIModule;
       AIModule *client;
@@ -282,6 +324,29 @@ namespace BWAPI
     private :
       Map map;
 
+      // Unit finder marks, one array per level of nested unit finder queries
+      static const int FINDER_INDEX_COUNT = UNIT_ARRAY_MAX_LENGTH + 1;
+      std::vector< std::vector<unsigned int> > finderMarks;
+      unsigned int finderGeneration;
+      int finderDepth;
+
+      // Ground distances from each source region that has been queried, indexed by region ID
+      mutable std::vector< std::vector<int> > groundDistances;
+      const std::vector<int> &_getGroundDistances(Region source) const;
+
+      // Clearance of each mini-tile in row major order, and the connected areas of mini-tiles with
+      // a clearance of at least 1, 2 and 3, labelled from 1 on first use
+      std::vector<unsigned char> clearance;
+      mutable std::vector<int> clearanceAreas[3];
+      void _computeClearance();
+      void _saveMapCache();
+      void _computeRegionNeighbors();
+      const std::vector<int> &_getClearanceAreas(int minClearance) const;
+      int _getClearanceArea(Position position, int minClearance) const;
+
+      // Where the footprint of each structure size fits, refreshed from the tile change feed
+      mutable PlacementMap placementMap;
+
       Unitset aliveUnits; //units alive on current frame
       Unitset dyingUnits; //units leaving aliveUnits set on current frame
 
@@ -291,17 +356,20 @@ namespace BWAPI
 
       Unitset selectedUnitSet;
 
+      UnitGrid unitGrid; // accessible units, only valid after updateUnits
+
       TilePosition::set startLocations;
 
       Forceset  forces;
       Playerset playerSet;
 
-      Unitset       minerals;
-      Unitset       geysers;
-      Unitset       neutralUnits;
+      IndexedUnitset minerals;
+      IndexedUnitset geysers;
+      IndexedUnitset neutralUnits;
       Bulletset     bullets;
       Position::set nukeDots;
-      Unitset pylons;
+      IndexedUnitset pylons;
+      PowerGrid     powerGrid;
 
       Unitset staticMinerals;
       Unitset staticGeysers;
@@ -310,7 +378,7 @@ namespace BWAPI
       Regionset regionsList;
 
       BulletImpl* bulletArray[BULLET_ARRAY_MAX_LENGTH];
-      std::vector< std::vector<Command *> > commandBuffer;
+      CommandBuffer commandBuffer;
       /** Will update the unitsOnTile content, should be called every frame. */
       void updateUnits();
       void updateBullets();
@@ -380,12 +448,54 @@ namespace BWAPI
       bool externalModuleConnected;
       bool calledMatchEnd;
       bool tournamentCheck(Tournament::ActionID type, void *parameter = nullptr);
-      std::list<UnitCommand> commandOptimizer[UnitCommandTypes::Enum::MAX];
+
+      // Commands waiting for the command optimizer, bucketed by type, target, target position and
+      // extra so that each bucket can be commanded with shared selections. Buckets are kept in the
+      // order they were first used this frame and keep their storage between frames.
+      struct CommandOptimizerKey
+      {
+        int   type;
+        Unit  target;
+        int   x;
+        int   y;
+        int   extra;
+        bool operator ==(const CommandOptimizerKey &other) const;
+      };
+      struct CommandOptimizerKeyHash
+      {
+        size_t operator()(const CommandOptimizerKey &key) const;
+      };
+      std::vector< std::vector<UnitCommand> > commandOptimizer;
+      size_t commandOptimizerBucketCount;
+      std::unordered_map<CommandOptimizerKey, size_t, CommandOptimizerKeyHash> commandOptimizerBuckets;
+      void executeCommandGroup(const Unitset &group, const UnitCommand &command);
 
       int lastEventTime;
       int addShape(const BWAPIC::Shape &s);
-      int addString(const char* text);
       int addText(BWAPIC::Shape &s, const char* text);
+      StringInterner textInterner;  // labels of the text shapes already in data->strings this frame
+      void drawShape(const BWAPIC::Shape &shape, const char *text);
+
+      /**
+       * Shapes that are drawn every frame until they are replaced, see createDrawList. Text shapes
+       * hold an index into texts in extra1.
+       */
+      struct DrawList
+      {
+        std::string name;
+        std::vector<BWAPIC::Shape> shapes;
+        std::vector<std::string> texts;
+        void clear()
+        {
+          shapes.clear();
+          texts.clear();
+        }
+      };
+      // Deques so that a list being recorded stays in place when another list is created
+      std::deque<DrawList> drawLists;        // created by the modules in this process
+      std::deque<DrawList> clientDrawLists;  // indexed by the handles the client chose
+      DrawList *recordingDrawList;  // list that the draw calls go to, or null for the current frame
+      int drawListShapes(const std::deque<DrawList> &lists);
 
   };
   /**
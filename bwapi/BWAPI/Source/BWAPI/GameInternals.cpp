@@ -23,6 +23,7 @@
 #include <BW/CBullet.h>
 #include <BW/CUnit.h>
 #include <BW/Dialog.h>
+#include <BW/Pathing.h>
 
 #include "../../../Debug.h"
 
@@ -51,6 +52,7 @@ namespace BWAPI
       , isTournamentCall(false)
       , lastEventTime(0)
       , data(server.data)
+      , staticData(server.staticData)
       , bTournamentMessageAppeared(false)
       , autoMenuEnemyCount(0)
       , autoMenuMinPlayerCount(0)
@@ -58,6 +60,10 @@ namespace BWAPI
       , autoMenuWaitPlayerTime(0)
       , externalModuleConnected(false)
       , isHost(false)
+      , finderGeneration(0)
+      , finderDepth(0)
+      , commandOptimizerBucketCount(0)
+      , recordingDrawList(nullptr)
   {
     BWAPI::BroodwarPtr = static_cast<Game*>(this);
 
@@ -270,6 +276,7 @@ namespace BWAPI
     {
       Broodwar << "Latency: " << getLatency() << std::endl;
       Broodwar << "New latency: " << getLatencyFrames() << " frames (" << getLatencyTime() << "ms)" << std::endl;
+      Broodwar << "Buffered commands: " << commandBuffer.getBufferedCount() << ", replayed this frame: " << commandBuffer.getReplayedCount() << std::endl;
     }
 // The following commands are knockoffs of Starcraft Beta's developer mode
     else if (cmd == "/pathdebug")
@@ -313,6 +320,48 @@ namespace BWAPI
   {
     map.copyToSharedMemory();
   }
+  //--------------------------------------------- SAVE MAP CACHE ---------------------------------------------
+  void GameImpl::_saveMapCache()
+  {
+    int width  = Map::getWidth();
+    int height = Map::getHeight();
+    MapCacheData *cache = mapCache.create(savedMapHash, width, height);
+
+    for ( int y = 0; y < height*4; ++y )
+      for ( int x = 0; x < width*4; ++x )
+        cache->isWalkable.set(x, y, map.walkable(x, y));
+
+    for ( int x = 0; x < width; ++x )
+      for ( int y = 0; y < height; ++y )
+      {
+        cache->isBuildable.set(x, y, map.buildable(x, y));
+        cache->groundHeight[x][y] = map.groundHeight(x, y);
+      }
+
+    if ( !clearance.empty() )
+      memcpy(cache->clearance, &clearance[0], clearance.size());
+    mapCache.save();
+  }
+  //------------------------------------------ COMPUTE REGION NEIGHBORS --------------------------------------
+  void GameImpl::_computeRegionNeighbors()
+  {
+    regionNeighborOffsets.assign(1, 0);
+    regionNeighbors.clear();
+    if ( !*BW::BWDATA::SAIPathing )
+      return;
+
+    u32 rgnCount = (*BW::BWDATA::SAIPathing)->regionCount;
+    for ( u32 i = 0; i < rgnCount; ++i )
+    {
+      RegionImpl *r = (RegionImpl*)(*BW::BWDATA::SAIPathing)->regions[i].unk_28;
+      if ( r )
+      {
+        foreach ( Region n, r->getNeighbors() )
+          regionNeighbors.push_back((unsigned short)n->getID());
+      }
+      regionNeighborOffsets.push_back(regionNeighbors.size());
+    }
+  }
 
   //------------------------------------------- INTERFACE EVENT UPDATE ---------------------------------------
   void GameImpl::processInterfaceEvents()
@@ -386,6 +435,7 @@ namespace BWAPI
     this->discoverUnits.clear();
     this->accessibleUnits.clear();
     this->evadeUnits.clear();
+    this->unitGrid.invalidate();
     this->lastEvadedUnits.clear();
     this->selectedUnitSet.clear();
     this->startLocations.clear();
@@ -395,6 +445,7 @@ namespace BWAPI
     this->neutralUnits.clear();
     this->bullets.clear();
     this->pylons.clear();
+    this->powerGrid.clear();
     this->staticMinerals.clear();
     this->staticGeysers.clear();
     this->staticNeutralUnits.clear();
@@ -411,15 +462,17 @@ namespace BWAPI
     MemZero(flags);
 
     // Clear the latency buffer
-    for(unsigned int j = 0; j < this->commandBuffer.size(); ++j)
-      for (unsigned int i = 0; i < this->commandBuffer[j].size(); ++i)
-        delete this->commandBuffer[j][i];
     this->commandBuffer.clear();
-    this->commandBuffer.reserve(16);
 
     // Clear the command optimization buffer
-    for ( int i = 0; i < UnitCommandTypes::None; ++i )
+    for ( size_t i = 0; i < commandOptimizerBucketCount; ++i )
       commandOptimizer[i].clear();
+    commandOptimizerBucketCount = 0;
+    commandOptimizerBuckets.clear();
+    MemZero(commandOptimizerSavedSelects);
+
+    // Remove the draw lists of the match
+    this->clearDrawLists();
 
     // Delete all dead units
     for ( Unitset::iterator d = this->deadUnits.begin(); d != this->deadUnits.end(); ++d )
@@ -430,6 +483,13 @@ namespace BWAPI
     for ( Regionset::iterator r = this->regionsList.begin(); r != this->regionsList.end(); ++r )
       delete static_cast<RegionImpl*>(*r);
     this->regionsList.clear();
+    this->groundDistances.clear();
+    this->regionNeighborOffsets.clear();
+    this->regionNeighbors.clear();
+    this->clearance.clear();
+    for ( int i = 0; i < 3; ++i )
+      this->clearanceAreas[i].clear();
+    this->mapCache.close();
 
     // Reset game speeds and text size
     this->setLocalSpeed(-1);
@@ -340,7 +340,10 @@ namespace BWAPI
       else
       {
         if ( unitPlayer == Broodwar->self() && type == UnitTypes::Protoss_Pylon )
+        {
           pylons.insert(u);
+          powerGrid.addPylon(u);
+        }
       }
     }
     foreach(UnitImpl* u, evadeUnits)
@@ -365,8 +368,11 @@ namespace BWAPI
       else if ( unitPlayer == Broodwar->self() && type == UnitTypes::Protoss_Pylon )
       {
         pylons.erase(u);
+        powerGrid.removePylon(u);
       }
     }
+    // Pylons only power the grid once they complete
+    powerGrid.update();
 
     foreach(UnitImpl* i, accessibleUnits)
     {
@@ -459,12 +465,14 @@ namespace BWAPI
     static Unitset selectedU;
 
     // Update all unit data
+    unitGrid.invalidate();
     computeUnitExistence();
     computePrimaryUnitSets();
     extractUnitData();
     augmentUnitData();
     applyLatencyCompensation();
     computeSecondaryUnitSets();
+    unitGrid.rebuild(accessibleUnits, this->mapWidth()*32, this->mapHeight()*32);
 
     // Update selection data
     selectedU = selectedUnitSet;
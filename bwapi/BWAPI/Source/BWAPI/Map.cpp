@@ -7,7 +7,10 @@
 #include <BW/MiniTileFlags.h>
 #include "GameImpl.h"
 #include "PlayerImpl.h"
+#include "MapCache.h"
 #include <fstream>
+#include <cstring>
+#include <emmintrin.h>
 #include <Util/sha1.h>
 
 #include "../../../Debug.h"
@@ -15,10 +18,76 @@
 using namespace std;
 namespace BWAPI
 {
+  namespace
+  {
+    static_assert(sizeof(BW::activeTile) == 4, "activeTile is read as a 32 bit value");
+
+    typedef TileLayer<256,256>::Word TileWord;
+
+    // Selects one tile layer from the 32 bits of an activeTile. A tile is set in the layer when
+    // (bits & mask) != value.
+    struct TileTest
+    {
+      u32 mask;
+      u32 value;
+    };
+    const int TILE_TEST_COUNT = 4;
+
+    u32 tileBits(const BW::activeTile &tile)
+    {
+      u32 bits;
+      memcpy(&bits, &tile, sizeof(bits));
+      return bits;
+    }
+
+    // Packs one row of tiles into one word per 64 tiles for each test. Four tiles are tested
+    // at once with SSE2, each test producing 4 bits through movemask.
+    void packTileRow(const BW::activeTile *row, int width, const TileTest (&tests)[TILE_TEST_COUNT], TileWord *(&out)[TILE_TEST_COUNT])
+    {
+      __m128i masks[TILE_TEST_COUNT], values[TILE_TEST_COUNT];
+      for ( int t = 0; t < TILE_TEST_COUNT; ++t )
+      {
+        masks[t]  = _mm_set1_epi32(tests[t].mask);
+        values[t] = _mm_set1_epi32(tests[t].value);
+      }
+
+      for ( int wordStart = 0; wordStart < width; wordStart += 64 )
+      {
+        TileWord words[TILE_TEST_COUNT] = { 0 };
+        int wordEnd = wordStart + 64 < width ? wordStart + 64 : width;
+
+        int x = wordStart;
+        for ( ; x + 4 <= wordEnd; x += 4 )
+        {
+          __m128i tiles = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[x]));
+          for ( int t = 0; t < TILE_TEST_COUNT; ++t )
+          {
+            __m128i same = _mm_cmpeq_epi32(_mm_and_si128(tiles, masks[t]), values[t]);
+            TileWord bits = ~_mm_movemask_ps(_mm_castsi128_ps(same)) & 0xF;
+            words[t] |= bits << (x - wordStart);
+          }
+        }
+        for ( ; x < wordEnd; ++x )
+        {
+          u32 bits = tileBits(row[x]);
+          for ( int t = 0; t < TILE_TEST_COUNT; ++t )
+          {
+            if ( (bits & tests[t].mask) != tests[t].value )
+              words[t] |= (TileWord)1 << (x - wordStart);
+          }
+        }
+
+        for ( int t = 0; t < TILE_TEST_COUNT; ++t )
+          out[t][wordStart/64] = words[t];
+      }
+    }
+  }
   //---------------------------------------------- CONSTRUCTOR -----------------------------------------------
   Map::Map()
       : activeTiles(nullptr)
+      , tileLayersValid(false)
   {
+    tileChanges.sequence = 0;
   }
   //----------------------------------------------- DESTRUCTOR -----------------------------------------------
   Map::~Map()
@@ -68,42 +137,103 @@ namespace BWAPI
     std::string mapName( BW::BWDATA::CurrentMapName );
     return mapName;
   }
-  void Map::copyToSharedMemory()
+  //------------------------------------------- UPDATE TILE LAYERS -------------------------------------------
+  void Map::updateTileLayers()
   {
+    if ( !activeTiles )
+      return;
+
     int w = buildability.getWidth();
     int h = buildability.getHeight();
-    GameData* data = BroodwarImpl.server.data;
     bool completeMapInfo = Broodwar->isFlagEnabled(Flag::CompleteMapInformation);
-    if ( BroodwarImpl.isReplay() )
+
+    // Locate the fields within the 32 bits of a tile
+    BW::activeTile field;
+    memset(&field, 0, sizeof(field));
+    field.bVisibilityFlags = 0xFF;
+    u32 visibilityBits = tileBits(field);
+
+    memset(&field, 0, sizeof(field));
+    field.bExploredFlags = 0xFF;
+    u32 exploredBits = tileBits(field);
+
+    // Creep as hasCreep sees it, preplaced creep only has bHasCreep
+    memset(&field, 0, sizeof(field));
+    field.bTemporaryCreep = 1;
+    field.bHasCreep       = 1;
+    u32 creepBits = tileBits(field);
+
+    memset(&field, 0, sizeof(field));
+    field.bCurrentlyOccupied = 1;
+    u32 occupiedBits = tileBits(field);
+
+    // A tile is visible in a replay if anyone can see it, otherwise the player's flag is cleared
+    u32 playerMask = 0xFFFFFFFF;
+    if ( !BroodwarImpl.isReplay() )
+      playerMask = 0x01010101 * (1 << BroodwarImpl.BWAPIPlayer->getIndex());
+
+    TileTest tests[TILE_TEST_COUNT] = {
+      { visibilityBits & playerMask, visibilityBits & playerMask },
+      { exploredBits & playerMask,   exploredBits & playerMask },
+      { creepBits,    0 },
+      { occupiedBits, 0 }
+    };
+
+    tileChanges.clear();
+    const int wordCount = TileLayer<256,256>::WORDS_PER_ROW;
+    for ( int y = 0; y < h; ++y )
     {
-      for(int x = 0; x < w; ++x)
+      TileWord *rows[TILE_TEST_COUNT] = {
+        visibleTiles.rows[y],
+        exploredTiles.rows[y],
+        creepTiles.rows[y],
+        occupiedTiles.rows[y]
+      };
+
+      // Keep the previous frame's row to find the tiles that changed
+      TileWord previous[TILE_TEST_COUNT][wordCount];
+      for ( int t = 0; t < TILE_TEST_COUNT; ++t )
+        memcpy(previous[t], rows[t], sizeof(previous[t]));
+
+      packTileRow(&(*activeTiles)[y][0], w, tests, rows);
+
+      // Creep and buildings are hidden by the fog of war
+      if ( !BroodwarImpl.isReplay() && !completeMapInfo )
       {
-        for(int y = 0; y < h; ++y)
+        for ( int i = 0; i < wordCount; ++i )
         {
-          BW::activeTile tileData = (*activeTiles)[y][x];
-          data->isVisible[x][y]  = tileData.bVisibilityFlags   != 255;
-          data->isExplored[x][y] = tileData.bExploredFlags     != 255;
-          data->hasCreep[x][y]   = tileData.bTemporaryCreep    != 0;
-          data->isOccupied[x][y] = tileData.bCurrentlyOccupied != 0;
+          rows[2][i] &= rows[0][i];
+          rows[3][i] &= rows[0][i];
         }
       }
-    }
-    else
-    {
-      int playerIndex = BroodwarImpl.BWAPIPlayer->getIndex();
-      u32 playerFlag = 1 << playerIndex;
-      for(int x = 0; x < w; ++x)
+
+      if ( tileLayersValid )
       {
-        for(int y = 0; y < h; ++y)
-        {
-          BW::activeTile tileData = (*activeTiles)[y][x];
-          data->isVisible[x][y]   = !(tileData.bVisibilityFlags & playerFlag);
-          data->isExplored[x][y]  = !(tileData.bExploredFlags & playerFlag);
-          data->hasCreep[x][y]    = (data->isVisible[x][y] || completeMapInfo) && tileData.bTemporaryCreep != 0;
-          data->isOccupied[x][y]  = (data->isVisible[x][y] || completeMapInfo) && tileData.bCurrentlyOccupied != 0;
-        }
+        for ( int i = 0; i < wordCount; ++i )
+          tileChanges.addWord(y, i, rows[0][i] ^ previous[0][i], rows[1][i] ^ previous[1][i], rows[2][i] ^ previous[2][i], rows[3][i] ^ previous[3][i]);
       }
     }
+
+    // Without a previous frame, everything has changed
+    if ( !tileLayersValid )
+      tileChanges.markAll();
+    tileLayersValid = true;
+  }
+  //-------------------------------------------- GET TILE CHANGES --------------------------------------------
+  const TileChangeFeed &Map::getTileChanges() const
+  {
+    return tileChanges;
+  }
+  //------------------------------------------ COPY TO SHARED MEMORY -----------------------------------------
+  void Map::copyToSharedMemory()
+  {
+    GameData* data = BroodwarImpl.server.data;
+    size_t rowBytes = buildability.getHeight()*sizeof(visibleTiles.rows[0]);
+    memcpy(data->isVisible.rows,  visibleTiles.rows,  rowBytes);
+    memcpy(data->isExplored.rows, exploredTiles.rows, rowBytes);
+    memcpy(data->hasCreep.rows,   creepTiles.rows,    rowBytes);
+    memcpy(data->isOccupied.rows, occupiedTiles.rows, rowBytes);
+    tileChanges.copyTo(data->tileChanges);
   }
   //------------------------------------------------ BUILDABLE -----------------------------------------------
   bool Map::buildable(int x, int y) const
@@ -161,16 +291,27 @@ namespace BWAPI
     return (*this->activeTiles)[y][x].bGroundHeight;
   }
   //-------------------------------------------------- LOAD --------------------------------------------------
-  void Map::load()
+  void Map::load(const MapCacheData *cache)
   {
     if ( activeTiles )
     {
       delete activeTiles;
       activeTiles = nullptr;
     }
+    tileLayersValid = false;
     buildability.resize(Map::getWidth(), Map::getHeight());
     walkability.resize(Map::getWidth()*4, Map::getHeight()*4);
     activeTiles = new Util::RectangleArray<BW::activeTile>(Map::getHeight(), Map::getWidth(), *BW::BWDATA::ActiveTileArray);
+    if ( cache )
+    {
+      for ( unsigned int y = 0; y < buildability.getHeight(); ++y )
+        for ( unsigned int x = 0; x < buildability.getWidth(); ++x )
+          this->buildability[x][y] = cache->isBuildable.get(x, y);
+      for ( unsigned int y = 0; y < walkability.getHeight(); ++y )
+        for ( unsigned int x = 0; x < walkability.getWidth(); ++x )
+          this->walkability[x][y] = cache->isWalkable.get(x, y);
+      return;
+    }
     setBuildability();
     setWalkability();
   }
@@ -1,11 +1,14 @@
 #pragma once
 #include <string>
 #include <Util/RectangleArray.h>
+#include <BWAPI/Client/TileLayer.h>
 
 #include <BW/Offsets.h>
 
 namespace BWAPI
 {
+  struct MapCacheData;
+
   /**
    * Interface to acces broodwar map data. Loads buildability/walkability when
    * constructed from the current map. It means it that instance of this class
@@ -35,11 +38,17 @@ namespace BWAPI
       bool isOccupied(int x, int y) const;
       int  groundHeight(int x, int y) const;
 
-      /** Loads buildability/walkability arrays from the currently opened map. */
-      void load();
+      /** Loads buildability/walkability arrays from the currently opened map, or from the map
+       * cache when one is given. */
+      void load(const MapCacheData *cache = nullptr);
 
       /** Returns a value that represents the map's terrain. */
       static std::string getMapHash();
+
+      /** Packs the visibility, exploration, creep and occupied layers of the current frame and
+       * records the tiles that changed since the previous frame. */
+      void updateTileLayers();
+      const TileChangeFeed &getTileChanges() const;
       void copyToSharedMemory();
 
     private :
@@ -49,6 +58,12 @@ namespace BWAPI
       Util::RectangleArray<BW::activeTile> *activeTiles;
       Util::RectangleArray<bool> buildability;
       Util::RectangleArray<bool> walkability;
+      TileLayer<256,256> visibleTiles;
+      TileLayer<256,256> exploredTiles;
+      TileLayer<256,256> creepTiles;
+      TileLayer<256,256> occupiedTiles;
+      TileChangeFeed tileChanges;
+      bool tileLayersValid;  // false until the layers have been packed for the current map
       void setBuildability();
       void setWalkability();
   };
@@ -0,0 +1,140 @@
+#include "MapCache.h"
+#include "../Config.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <sstream>
+
+#include "../../../Debug.h"
+
+namespace BWAPI
+{
+  static const char MAP_CACHE_MAGIC[4] = { 'B', 'W', 'M', 'C' };
+
+  // Map::getMapHash gives an error message instead of a hash when it cannot read the map, and all
+  // maps with that message would share one file
+  static bool isMapHash(const std::string &mapHash)
+  {
+    if ( mapHash.size() != 40 )
+      return false;
+    for ( size_t i = 0; i < mapHash.size(); ++i )
+    {
+      if ( !isxdigit((unsigned char)mapHash[i]) )
+        return false;
+    }
+    return true;
+  }
+
+  //----------------------------------------------- CONSTRUCTOR ----------------------------------------------
+  MapCache::MapCache()
+    : fileHandle(INVALID_HANDLE_VALUE)
+    , mappingHandle(NULL)
+    , mappedData(nullptr)
+    , createdData(nullptr)
+  {
+  }
+  //----------------------------------------------- DESTRUCTOR -----------------------------------------------
+  MapCache::~MapCache()
+  {
+    this->close();
+  }
+  //------------------------------------------------ FILE NAME -----------------------------------------------
+  std::string MapCache::getFileName(const std::string &mapHash)
+  {
+    return installPath + "bwapi-data\\cache\\" + mapHash + ".bin";
+  }
+  //-------------------------------------------------- OPEN --------------------------------------------------
+  bool MapCache::open(const std::string &mapHash, int mapWidth, int mapHeight)
+  {
+    this->close();
+    if ( !mapCacheEnabled || !isMapHash(mapHash) )
+      return false;
+
+    fileHandle = CreateFile(getFileName(mapHash).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if ( fileHandle == INVALID_HANDLE_VALUE )
+      return false;
+
+    // A file of the wrong size was written by another version or was cut short
+    if ( GetFileSize(fileHandle, NULL) != sizeof(MapCacheData) )
+    {
+      this->close();
+      return false;
+    }
+
+    mappingHandle = CreateFileMapping(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if ( mappingHandle )
+      mappedData = (const MapCacheData*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, sizeof(MapCacheData));
+
+    if ( !mappedData ||
+         memcmp(mappedData->magic, MAP_CACHE_MAGIC, sizeof(MAP_CACHE_MAGIC)) != 0 ||
+         mappedData->version   != MapCacheData::VERSION ||
+         mappedData->mapWidth  != mapWidth ||
+         mappedData->mapHeight != mapHeight ||
+         mapHash != mappedData->mapHash )
+    {
+      this->close();
+      return false;
+    }
+    return true;
+  }
+  //------------------------------------------------- CREATE -------------------------------------------------
+  MapCacheData *MapCache::create(const std::string &mapHash, int mapWidth, int mapHeight)
+  {
+    this->close();
+    createdData = new MapCacheData;
+    memset(createdData, 0, sizeof(MapCacheData));
+
+    memcpy(createdData->magic, MAP_CACHE_MAGIC, sizeof(MAP_CACHE_MAGIC));
+    createdData->version   = MapCacheData::VERSION;
+    createdData->mapWidth  = mapWidth;
+    createdData->mapHeight = mapHeight;
+    strncpy(createdData->mapHash, mapHash.c_str(), sizeof(createdData->mapHash) - 1);
+    return createdData;
+  }
+  //-------------------------------------------------- SAVE --------------------------------------------------
+  void MapCache::save() const
+  {
+    if ( !mapCacheEnabled || !createdData || !isMapHash(createdData->mapHash) )
+      return;
+
+    // Write to a file of our own first, so that another instance never maps a partial file
+    std::string fileName = getFileName(createdData->mapHash);
+    std::stringstream tempName;
+    tempName << fileName << "." << GetCurrentProcessId() << ".tmp";
+
+    CreateDirectory((installPath + "bwapi-data\\cache").c_str(), NULL);
+    FILE *f = fopen(tempName.str().c_str(), "wb");
+    if ( !f )
+      return;
+    bool written = fwrite(createdData, sizeof(MapCacheData), 1, f) == 1;
+    fclose(f);
+
+    // Another instance may have saved and mapped the same map in the meantime, which is fine
+    if ( !written || !MoveFileEx(tempName.str().c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING) )
+      DeleteFile(tempName.str().c_str());
+  }
+  //-------------------------------------------------- CLOSE -------------------------------------------------
+  void MapCache::close()
+  {
+    if ( mappedData )
+      UnmapViewOfFile(mappedData);
+    mappedData = nullptr;
+
+    if ( mappingHandle )
+      CloseHandle(mappingHandle);
+    mappingHandle = NULL;
+
+    if ( fileHandle != INVALID_HANDLE_VALUE )
+      CloseHandle(fileHandle);
+    fileHandle = INVALID_HANDLE_VALUE;
+
+    delete createdData;
+    createdData = nullptr;
+  }
+  //------------------------------------------------ GET DATA ------------------------------------------------
+  const MapCacheData *MapCache::getData() const
+  {
+    return mappedData ? mappedData : createdData;
+  }
+};
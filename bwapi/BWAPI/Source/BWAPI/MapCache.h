@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <windows.h>
+#include <BWAPI/Client/TileLayer.h>
+
+namespace BWAPI
+{
+  /**
+   * The static layers and analysis of a map. A copy is stored in bwapi-data\cache for every map
+   * that has been played, named after the map hash, so that later matches on the same map can
+   * map the file instead of recomputing it.
+   */
+  struct MapCacheData
+  {
+    /** Increase whenever the layout or the contents change, so that older files are ignored. */
+    static const int VERSION = 1;
+
+    char magic[4];
+    int  version;
+    char mapHash[44];
+    int  mapWidth;
+    int  mapHeight;
+
+    TileLayer<1024,1024> isWalkable;
+    TileLayer<256,256>   isBuildable;
+    int groundHeight[256][256];         // indexed [x][y] like GameData
+    unsigned char clearance[1024*1024]; // row major, mapWidth*4 mini-tiles per row
+  };
+
+  /**
+   * Loads the cache file of the current map, or creates the data in memory and saves it when
+   * there is no valid file yet. A map whose hash could not be computed is never cached, its data
+   * is created in memory for every match.
+   */
+  class MapCache
+  {
+    public :
+      MapCache();
+      ~MapCache();
+
+      /** Maps the cache file of the given map. Returns false if there is no file or if it was
+       * written by another version or for another map. */
+      bool open(const std::string &mapHash, int mapWidth, int mapHeight);
+
+      /** Starts an empty cache in memory, to be filled and then saved. */
+      MapCacheData *create(const std::string &mapHash, int mapWidth, int mapHeight);
+
+      /** Writes the cache started with create to disk. Failures are ignored, the data stays
+       * available in memory for the current match. */
+      void save() const;
+
+      /** Releases the data of the current map. */
+      void close();
+
+      /** Retrieves the data of the current map, or nullptr if none is loaded. */
+      const MapCacheData *getData() const;
+
+    private :
+      static std::string getFileName(const std::string &mapHash);
+
+      HANDLE fileHandle;
+      HANDLE mappingHandle;
+      const MapCacheData *mappedData;
+      MapCacheData *createdData;
+  };
+};
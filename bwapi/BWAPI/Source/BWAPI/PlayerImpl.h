@@ -6,6 +6,7 @@
 #include <BWAPI/Player.h>
 #include <BWAPI/Client/PlayerData.h>
 #include <BWAPI/Unitset.h>
+#include <BWAPI/IndexedUnitset.h>
 
 #include "UnitImpl.h"
 #include "ForceImpl.h"
@@ -110,7 +111,7 @@ namespace BWAPI
       ForceImpl   *force;
       PlayerData  data;
       PlayerData  *self;
-      Unitset     units;
+      IndexedUnitset units;
 
       s32 _repairedMinerals;
       s32 _repairedGas;
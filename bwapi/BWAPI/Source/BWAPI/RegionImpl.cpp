@@ -75,10 +75,6 @@ namespace BWAPI
         inaccessibleBestDist = dst;
         this->closestInaccessibleRgn = bwapiNeighbor;
       }
-
-      // Client compatibility for neighbors
-      ++self->neighborCount;
-      self->neighbors[n] = neighbor->getIndex();
     }
   }
   RegionImpl::~RegionImpl()
@@ -14,7 +14,9 @@
 #include "BulletImpl.h"
 #include "RegionImpl.h"
 #include <BWAPI/Client/GameData.h>
+#include <BWAPI/Client/StaticGameData.h>
 #include <BWAPI/Client/GameTable.h>
+#include <BWAPI/Client/FrameSync.h>
 
 #include <BW/Pathing.h>
 
@@ -32,10 +34,13 @@ namespace BWAPI
   Server::Server()
     : connected(false)
     , localOnly(false)
+    , lastObserverCheck(0)
     , data(nullptr)
+    , staticData(nullptr)
     , gameTable(nullptr)
     , gameTableIndex(-1)
     , mapFileHandle(nullptr)
+    , staticFileHandle(nullptr)
     , pEveryoneSID(NULL)
     , pACL(NULL)
     , pSD(NULL)
@@ -101,6 +106,8 @@ namespace BWAPI
           gameTable->gameInstances[gameTableIndex].serverProcessID = processID;
           gameTable->gameInstances[gameTableIndex].isConnected = false;
           gameTable->gameInstances[gameTableIndex].lastKeepAliveTime = GetTickCount();
+          for ( int i = 0; i < GameInstance::MAX_OBSERVERS; ++i )
+            gameTable->gameInstances[gameTableIndex].observerProcessIDs[i] = 0;
         } // if gameTable
       } // if gameTableFileHandle
 
@@ -113,13 +120,27 @@ namespace BWAPI
       mapFileHandle = CreateFileMapping( INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, size, ssShareName.str().c_str() );
       if ( mapFileHandle )
         data = (GameData*)MapViewOfFile(mapFileHandle, FILE_MAP_WRITE | FILE_MAP_READ, 0, 0, size);
+
+      // The static map data gets a section of its own, written once per match
+      std::stringstream ssStaticName;
+      ssStaticName << "Local\\bwapi_shared_memory_static_";
+      ssStaticName << processID;
+
+      staticFileHandle = CreateFileMapping( INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(StaticGameData), ssStaticName.str().c_str() );
+      if ( staticFileHandle )
+        staticData = (StaticGameData*)MapViewOfFile(staticFileHandle, FILE_MAP_WRITE | FILE_MAP_READ, 0, 0, sizeof(StaticGameData));
     } // if serverEnabled
 
     // check if memory was created or if we should create it locally
-    if ( !data )
+    if ( !data || !staticData )
     {
-      data      = (GameData*)malloc(size);
-      localOnly = true;
+      if ( data )
+        UnmapViewOfFile(data);
+      if ( staticData )
+        UnmapViewOfFile(staticData);
+      data       = (GameData*)malloc(size);
+      staticData = (StaticGameData*)malloc(sizeof(StaticGameData));
+      localOnly  = true;
     }
     initializeSharedMemory();
 
@@ -224,6 +245,11 @@ namespace BWAPI
       free(data);
       data = nullptr;
     }
+    if ( localOnly && staticData )
+    {
+      free(staticData);
+      staticData = nullptr;
+    }
 
     if ( this->pEveryoneSID )
       FreeSid(this->pEveryoneSID);
@@ -235,14 +261,16 @@ namespace BWAPI
   void Server::update()
   {
     // Reset data coming in to server
-    data->stringCount      = 0;
+    data->strings.clear();
     data->commandCount     = 0;
     data->unitCommandCount = 0;
+    data->unitCommandGroupUnitCount = 0;
     data->shapeCount       = 0;
     if (gameTable && gameTableIndex >= 0)
     {
       gameTable->gameInstances[gameTableIndex].lastKeepAliveTime = GetTickCount();
       gameTable->gameInstances[gameTableIndex].isConnected = connected;
+      releaseDeadObservers();
     }
     if (connected)
     {
@@ -256,22 +284,69 @@ namespace BWAPI
       // Update BWAPI DLL
       BroodwarImpl.processEvents();
 
-      static_cast<GameImpl*>(BroodwarPtr)->events.clear();
+      // A draw list left open by the AI module would swallow the shapes drawn by BWAPI itself
+      BroodwarImpl.endDrawList();
+
+      // Read-only observers still get every frame, but never hold up the game
+      if ( hasObservers() )
+        updateSharedMemory();
+      else
+        static_cast<GameImpl*>(BroodwarPtr)->events.clear();
       if (!static_cast<GameImpl*>(BroodwarPtr)->startedClient)
         checkForConnections();
     }
-    // Reset data going out to client
-    data->eventCount = 0;
-    data->eventStringCount = 0;
   }
   bool Server::isConnected()
   {
     return connected;
   }
+  bool Server::hasObservers() const
+  {
+    if ( localOnly || !gameTable || gameTableIndex < 0 )
+      return false;
+    for ( int i = 0; i < GameInstance::MAX_OBSERVERS; ++i )
+    {
+      if ( gameTable->gameInstances[gameTableIndex].observerProcessIDs[i] != 0 )
+        return true;
+    }
+    return false;
+  }
+  void Server::releaseDeadObservers()
+  {
+    // An observer that crashed or was killed never releases its slot, look for them once a second
+    DWORD now = GetTickCount();
+    if ( now - lastObserverCheck < 1000 )
+      return;
+    lastObserverCheck = now;
+
+    GameInstance &instance = gameTable->gameInstances[gameTableIndex];
+    for ( int i = 0; i < GameInstance::MAX_OBSERVERS; ++i )
+    {
+      DWORD processID = instance.observerProcessIDs[i];
+      if ( processID == 0 )
+        continue;
+
+      bool running = false;
+      HANDLE process = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processID);
+      if ( process )
+      {
+        DWORD exitCode = 0;
+        running = GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+        CloseHandle(process);
+      }
+      else
+        running = GetLastError() == ERROR_ACCESS_DENIED;
+
+      // Only free the slot if it was not claimed again in the meantime
+      if ( !running )
+        InterlockedCompareExchange((volatile LONG*)&instance.observerProcessIDs[i], 0, processID);
+    }
+  }
   int Server::addString(const char* text)
   {
-    StrCopy(data->eventStrings[data->eventStringCount], text);
-    return data->eventStringCount++;
+    int handle = data->eventStrings.add(text);
+    assert(handle != -1);
+    return handle;
   }
   int Server::addEvent(BWAPI::Event e)
   {
@@ -345,18 +420,28 @@ namespace BWAPI
     data->instanceID       = gdwProcNum;
     data->revision         = SVN_REV;
     data->isDebug          = (BUILD_DEBUG == 1);
+    data->frameSequence    = 0;
+    data->clientSequence   = 0;
+    data->frameLock        = 0;
     data->eventCount       = 0;
-    data->eventStringCount = 0;
+    data->eventStrings.clear();
     data->commandCount     = 0;
     data->unitCommandCount = 0;
+    data->unitCommandGroupUnitCount = 0;
     data->shapeCount       = 0;
-    data->stringCount      = 0;
-    data->mapFileName[0]   = 0;
-    data->mapPathName[0]   = 0;
-    data->mapName[0]       = 0;
-    data->mapHash[0]       = 0;
+    data->strings.clear();
+    data->staticGeneration = 0;
     data->hasGUI           = true;
     data->hasLatCom        = true;
+
+    staticData->revision          = SVN_REV;
+    staticData->generation        = 0;
+    staticData->mapFileName[0]    = 0;
+    staticData->mapPathName[0]    = 0;
+    staticData->mapName[0]        = 0;
+    staticData->mapHash[0]        = 0;
+    staticData->regionCount       = 0;
+    staticData->startLocationCount = 0;
     clearAll();
   }
   void Server::onMatchStart()
@@ -372,61 +457,94 @@ namespace BWAPI
     TilePosition mapSize( Broodwar->mapWidth(), Broodwar->mapHeight() );
     WalkPosition mapWalkSize( mapSize );
 
-    // Load walkability
-    for ( int x = 0; x < mapWalkSize.x; ++x )
+    // Load walkability, buildability and ground height from the map cache, which the game fills
+    // in at the start of the match if it was not loaded from disk
+    const MapCacheData *mapCache = BroodwarImpl.mapCache.getData();
+    if ( mapCache )
+    {
+      memcpy(&staticData->isWalkable, &mapCache->isWalkable, sizeof(staticData->isWalkable));
+      memcpy(&staticData->isBuildable, &mapCache->isBuildable, sizeof(staticData->isBuildable));
+      memcpy(staticData->getGroundHeight, mapCache->groundHeight, sizeof(staticData->getGroundHeight));
+    }
+    else
+    {
+      staticData->isWalkable.clear();
       for ( int y = 0; y < mapWalkSize.y; ++y )
-      {
-        data->isWalkable[x][y] = Broodwar->isWalkable(x, y);
-      }
+        for ( int x = 0; x < mapWalkSize.x; ++x )
+          staticData->isWalkable.set(x, y, Broodwar->isWalkable(x, y));
+
+      staticData->isBuildable.clear();
+      for ( int x = 0; x < mapSize.x; ++x )
+        for ( int y = 0; y < mapSize.y; ++y )
+        {
+          staticData->isBuildable.set(x, y, Broodwar->isBuildable(x, y));
+          staticData->getGroundHeight[x][y] = Broodwar->getGroundHeight(x, y);
+        }
+    }
 
-    // Load buildability, ground height, tile region id
+    // Load tile region id
     for ( int x = 0; x < mapSize.x; ++x )
       for ( int y = 0; y < mapSize.y; ++y )
       {
-        data->isBuildable[x][y]     = Broodwar->isBuildable(x, y);
-        data->getGroundHeight[x][y] = Broodwar->getGroundHeight(x, y);
         if ( *BW::BWDATA::SAIPathing )
-          data->mapTileRegionId[x][y] = (*BW::BWDATA::SAIPathing)->mapTileRegionId[y][x];
+          staticData->mapTileRegionId[x][y] = (*BW::BWDATA::SAIPathing)->mapTileRegionId[y][x];
         else
-          data->mapTileRegionId[x][y] = 0;
+          staticData->mapTileRegionId[x][y] = 0;
       }
 
     // Load pathing info
     if ( *BW::BWDATA::SAIPathing )
     {
-      data->regionCount = (*BW::BWDATA::SAIPathing)->regionCount;
+      staticData->regionCount = (*BW::BWDATA::SAIPathing)->regionCount;
       for(int i = 0; i < 5000; ++i)
       {
-        data->mapSplitTilesMiniTileMask[i] = (*BW::BWDATA::SAIPathing)->splitTiles[i].minitileMask;
-        data->mapSplitTilesRegion1[i]      = (*BW::BWDATA::SAIPathing)->splitTiles[i].rgn1;
-        data->mapSplitTilesRegion2[i]      = (*BW::BWDATA::SAIPathing)->splitTiles[i].rgn2;
+        staticData->mapSplitTilesMiniTileMask[i] = (*BW::BWDATA::SAIPathing)->splitTiles[i].minitileMask;
+        staticData->mapSplitTilesRegion1[i]      = (*BW::BWDATA::SAIPathing)->splitTiles[i].rgn1;
+        staticData->mapSplitTilesRegion2[i]      = (*BW::BWDATA::SAIPathing)->splitTiles[i].rgn2;
         // Region hack using a possibly unused variable (feeling risky, babe :) )
         if ( (*BW::BWDATA::SAIPathing)->regions[i].unk_28 )
-          data->regions[i] = *((RegionImpl*)(*BW::BWDATA::SAIPathing)->regions[i].unk_28)->getData();
+          staticData->regions[i] = *((RegionImpl*)(*BW::BWDATA::SAIPathing)->regions[i].unk_28)->getData();
         else
-          MemZero(data->regions[i]);
+          MemZero(staticData->regions[i]);
       }
     }
 
+    // Load region adjacency, truncated to what fits in shared memory
+    const std::vector<int> &neighborOffsets = BroodwarImpl.regionNeighborOffsets;
+    const std::vector<unsigned short> &neighbors = BroodwarImpl.regionNeighbors;
+    int neighborCount = (int)neighbors.size();
+    if ( neighborCount > StaticGameData::MAX_REGION_NEIGHBORS )
+      neighborCount = StaticGameData::MAX_REGION_NEIGHBORS;
+
+    staticData->regionNeighborOffsets[0] = 0;
+    for ( size_t i = 0; i < neighborOffsets.size() && i < 5001; ++i )
+      staticData->regionNeighborOffsets[i] = neighborOffsets[i] < neighborCount ? neighborOffsets[i] : neighborCount;
+    if ( neighborCount > 0 )
+      memcpy(staticData->regionNeighbors, &neighbors[0], neighborCount*sizeof(unsigned short));
+
     // Store the map size
     data->mapWidth  = mapSize.x;
     data->mapHeight = mapSize.y;
 
     // Retrieve map strings
-    StrCopy(data->mapFileName, Broodwar->mapFileName());
-    StrCopy(data->mapPathName, Broodwar->mapPathName());
-    StrCopy(data->mapName, Broodwar->mapName());
-    StrCopy(data->mapHash, Broodwar->mapHash());
+    StrCopy(staticData->mapFileName, Broodwar->mapFileName());
+    StrCopy(staticData->mapPathName, Broodwar->mapPathName());
+    StrCopy(staticData->mapName, Broodwar->mapName());
+    StrCopy(staticData->mapHash, Broodwar->mapHash());
 
-    data->startLocationCount = Broodwar->getStartLocations().size();
+    staticData->startLocationCount = Broodwar->getStartLocations().size();
     int i = 0;
     foreach(TilePosition t, Broodwar->getStartLocations())
     {
-      data->startLocations[i].x = t.x;
-      data->startLocations[i].y = t.y;
+      staticData->startLocations[i].x = t.x;
+      staticData->startLocations[i].y = t.y;
       i++;
     }
 
+    // The static data is complete, tell clients which generation belongs to this match
+    staticData->generation++;
+    data->staticGeneration = staticData->generation;
+
     //static force data
     data->forces[0].name[0] = '\0';
     foreach(Force i, Broodwar->getForces())
@@ -488,9 +606,73 @@ namespace BWAPI
     unitLookup.clear();
   }
 
+  static void copyDynamicPlayerData(PlayerData *p, PlayerImpl *player)
+  {
+    PlayerData* p2 = player->self;
+
+    p->isVictorious     = player->isVictorious();
+    p->isDefeated       = player->isDefeated();
+    p->leftGame         = player->leftGame();
+    p->minerals         = p2->minerals;
+    p->gas              = p2->gas;
+    p->gatheredMinerals = p2->gatheredMinerals;
+    p->gatheredGas      = p2->gatheredGas;
+    p->repairedMinerals = p2->repairedMinerals;
+    p->repairedGas      = p2->repairedGas;
+    p->refundedMinerals = p2->refundedMinerals;
+    p->refundedGas      = p2->refundedGas;
+    for(int j = 0; j < 3; ++j)
+    {
+      p->supplyTotal[j]  = p2->supplyTotal[j];
+      p->supplyUsed[j]  = p2->supplyUsed[j];
+    }
+    for(int j = 0; j < UnitTypes::Enum::MAX; ++j)
+    {
+      p->allUnitCount[j]        = p2->allUnitCount[j];
+      p->visibleUnitCount[j]    = p2->visibleUnitCount[j];
+      p->completedUnitCount[j]  = p2->completedUnitCount[j];
+      p->deadUnitCount[j]       = p2->deadUnitCount[j];
+      p->killedUnitCount[j]     = p2->killedUnitCount[j];
+    }
+    p->totalUnitScore     = p2->totalUnitScore;
+    p->totalKillScore     = p2->totalKillScore;
+    p->totalBuildingScore = p2->totalBuildingScore;
+    p->totalRazingScore   = p2->totalRazingScore;
+    p->customScore        = p2->customScore;
+
+    for(int j = 0; j < 63; ++j)
+    {
+      p->upgradeLevel[j] = p2->upgradeLevel[j];
+      p->isUpgrading[j]  = p2->isUpgrading[j];
+    }
+
+    for(int j = 0; j < 47; ++j)
+    {
+      p->hasResearched[j] = p2->hasResearched[j];
+      p->isResearching[j] = p2->isResearching[j];
+    }
+    memcpy(p->isResearchAvailable, p2->isResearchAvailable, sizeof(p->isResearchAvailable));
+    memcpy(p->isUnitAvailable, p2->isUnitAvailable, sizeof(p->isUnitAvailable));
+    memcpy(p->maxUpgradeLevel, p2->maxUpgradeLevel, sizeof(p->maxUpgradeLevel));
+  }
+  void Server::syncUnitData(int id, const UnitData &unitData)
+  {
+    data->frameSyncBytes += syncFrameSlot(data->units[id], unitData, id, deltaSyncEnabled, data->changedUnits, data->changedUnitCount);
+  }
+  void Server::syncBulletData(int id, const BulletData &bulletData)
+  {
+    data->frameSyncBytes += syncFrameSlot(data->bullets[id], bulletData, id, deltaSyncEnabled, data->changedBullets, data->changedBulletCount);
+  }
   void Server::updateSharedMemory()
   {
     bool matchStarting = false;
+
+    // Observers read without waiting for us, let them know the frame is being rewritten
+    InterlockedIncrement((volatile LONG*)&data->frameLock);
+
+    // Reset data going out to client
+    data->eventCount = 0;
+    data->eventStrings.clear();
     
     // iterate events
     foreach(Event e, BroodwarImpl.events)
@@ -500,8 +682,8 @@ namespace BWAPI
       if (e.getType() == EventType::MatchStart)
         matchStarting = true;
 
-      // ignore if tournament AI not loaded
-      if ( !BroodwarImpl.tournamentAI )
+      // ignore if tournament AI not loaded, or if the DLL module already received the event
+      if ( !BroodwarImpl.tournamentAI || !connected )
         continue;
 
       // call the tournament module callbacks for server/client
@@ -566,8 +748,15 @@ namespace BWAPI
       }
       BroodwarImpl.isTournamentCall = false;
     }
+    // Reset the frame delta
+    data->hasFrameDelta       = deltaSyncEnabled;
+    data->changedUnitCount    = 0;
+    data->changedPlayerCount  = 0;
+    data->changedBulletCount  = 0;
+    data->frameSyncBytes      = 0;
+
     foreach(UnitImpl* u, BroodwarImpl.lastEvadedUnits)
-      data->units[u->getID()] = u->data;
+      syncUnitData(u->getID(), u->data);
 
     static_cast<GameImpl*>(BroodwarPtr)->events.clear();
 
@@ -622,57 +811,23 @@ namespace BWAPI
         if ( id >= 12 )
           continue;
         PlayerData* p  = &(data->players[id]);
-        PlayerData* p2 = i->self;
-
-        p->isVictorious     = i->isVictorious();
-        p->isDefeated       = i->isDefeated();
-        p->leftGame         = i->leftGame();
-        p->minerals         = p2->minerals;
-        p->gas              = p2->gas;
-        p->gatheredMinerals = p2->gatheredMinerals;
-        p->gatheredGas      = p2->gatheredGas;
-        p->repairedMinerals = p2->repairedMinerals;
-        p->repairedGas      = p2->repairedGas;
-        p->refundedMinerals = p2->refundedMinerals;
-        p->refundedGas      = p2->refundedGas;
-        for(int j = 0; j < 3; ++j)
-        {
-          p->supplyTotal[j]  = p2->supplyTotal[j];
-          p->supplyUsed[j]  = p2->supplyUsed[j];
-        }
-        for(int j = 0; j < UnitTypes::Enum::MAX; ++j)
-        {
-          p->allUnitCount[j]        = p2->allUnitCount[j];
-          p->visibleUnitCount[j]    = p2->visibleUnitCount[j];
-          p->completedUnitCount[j]  = p2->completedUnitCount[j];
-          p->deadUnitCount[j]       = p2->deadUnitCount[j];
-          p->killedUnitCount[j]     = p2->killedUnitCount[j];
-        }
-        p->totalUnitScore     = p2->totalUnitScore;
-        p->totalKillScore     = p2->totalKillScore;
-        p->totalBuildingScore = p2->totalBuildingScore;
-        p->totalRazingScore   = p2->totalRazingScore;
-        p->customScore        = p2->customScore;
-
-        for(int j = 0; j < 63; ++j)
+        if ( !deltaSyncEnabled )
         {
-          p->upgradeLevel[j] = p2->upgradeLevel[j];
-          p->isUpgrading[j]  = p2->isUpgrading[j];
+          copyDynamicPlayerData(p, i);
+          data->frameSyncBytes += sizeof(PlayerData);
+          continue;
         }
 
-        for(int j = 0; j < 47; ++j)
-        {
-          p->hasResearched[j] = p2->hasResearched[j];
-          p->isResearching[j] = p2->isResearching[j];
-        }
-        memcpy(p->isResearchAvailable, p2->isResearchAvailable, sizeof(p->isResearchAvailable));
-        memcpy(p->isUnitAvailable, p2->isUnitAvailable, sizeof(p->isUnitAvailable));
-        memcpy(p->maxUpgradeLevel, p2->maxUpgradeLevel, sizeof(p->maxUpgradeLevel));
+        // Only rewrite the slot if something changed
+        PlayerData next;
+        memcpy(&next, p, sizeof(PlayerData));
+        copyDynamicPlayerData(&next, i);
+        data->frameSyncBytes += syncFrameSlot(*p, next, id, true, data->changedPlayers, data->changedPlayerCount);
       }
 
       //dynamic unit data
       foreach(UnitImpl *i, Broodwar->getAllUnits())
-        data->units[i->getID()] = i->data;
+        syncUnitData(i->getID(), i->data);
 
       for(int i = 0; i < UNIT_ARRAY_MAX_LENGTH; ++i)
       {
@@ -721,7 +876,7 @@ namespace BWAPI
 
       //dynamic bullet data
       for(int id = 0; id < 100; ++id)
-        data->bullets[id] = BroodwarImpl.getBulletFromIndex(id)->data;
+        syncBulletData(id, BroodwarImpl.getBulletFromIndex(id)->data);
       
       //dynamic nuke dot data
       int j = 0;
@@ -736,6 +891,10 @@ namespace BWAPI
     }
     if (matchStarting)
       Server::onMatchStart();
+
+    // Publish the frame
+    InterlockedIncrement((volatile LONG*)&data->frameLock);
+    InterlockedIncrement((volatile LONG*)&data->frameSequence);
   }
 
   int Server::getForceID(Force force)
@@ -805,12 +964,17 @@ namespace BWAPI
         DisconnectNamedPipe(pipeObjectHandle);
         connected = false;
         setWaitForResponse(false);
+        // The next client starts its draw list handles over
+        BroodwarImpl.clearClientDrawLists();
         break;
       }
     }
   }
   void Server::processCommands()
   {
+    // The shapes a client draws into a draw list are written to the frame's shapes between the
+    // BeginDrawList and EndDrawList commands
+    int drawList = -1, drawListFirstShape = 0;
     for(int i = 0; i < data->commandCount; ++i)
     {
       BWAPIC::CommandType::Enum c = data->commands[i].type;
@@ -832,11 +996,11 @@ namespace BWAPI
         break;
       case BWAPIC::CommandType::Printf:
         if (Broodwar->isInGame())
-          Broodwar->printf("%s", data->strings[v1]);
+          Broodwar->printf("%s", data->strings.get(v1));
         break;
       case BWAPIC::CommandType::SendText:
         if (Broodwar->isInGame())
-          Broodwar->sendText("%s", data->strings[v1]);
+          Broodwar->sendText("%s", data->strings.get(v1));
         break;
       case BWAPIC::CommandType::PauseGame:
         if (Broodwar->isInGame())
@@ -869,7 +1033,7 @@ namespace BWAPI
           Broodwar->setFrameSkip(v1);
         break;
       case BWAPIC::CommandType::SetMap:
-        Broodwar->setMap(data->strings[v1]);
+        Broodwar->setMap(data->strings.get(v1));
         break;
       case BWAPIC::CommandType::SetAllies:
         if (Broodwar->isInGame())
@@ -887,6 +1051,27 @@ namespace BWAPI
         if ( Broodwar->isInGame() )
           Broodwar->setRevealAll(v1 != 0);
         break;
+      case BWAPIC::CommandType::CreateDrawList:
+        BroodwarImpl.resetClientDrawList(v1, data->strings.get(v2));
+        break;
+      case BWAPIC::CommandType::BeginDrawList:
+        drawList = v1;
+        drawListFirstShape = v2;
+        break;
+      case BWAPIC::CommandType::EndDrawList:
+        if ( v1 == drawList && drawListFirstShape >= 0 && drawListFirstShape <= v2 && v2 <= data->shapeCount )
+        {
+          BroodwarImpl.setClientDrawListShapes(v1, &data->shapes[drawListFirstShape], v2 - drawListFirstShape);
+
+          // The list draws them from now on, not the shapes of this frame
+          for ( int s = drawListFirstShape; s < v2; ++s )
+            data->shapes[s].type = BWAPIC::ShapeType::None;
+        }
+        drawList = -1;
+        break;
+      case BWAPIC::CommandType::ClearDrawList:
+        BroodwarImpl.clearClientDrawList(v1);
+        break;
       default:
         break;
       }
@@ -895,14 +1080,37 @@ namespace BWAPI
     {
       for ( int i = 0; i < data->unitCommandCount; ++i )
       {
-        if (data->unitCommands[i].unitIndex < 0 || data->unitCommands[i].unitIndex >= (int)unitVector.size())
-          continue;
-        Unit unit   = unitVector[data->unitCommands[i].unitIndex];
+        const BWAPIC::UnitCommand &c = data->unitCommands[i];
         Unit target = nullptr;
-        if (data->unitCommands[i].targetIndex >= 0 && data->unitCommands[i].targetIndex < (int)unitVector.size())
-          target = unitVector[data->unitCommands[i].targetIndex];
+        if (c.targetIndex >= 0 && c.targetIndex < (int)unitVector.size())
+          target = unitVector[c.targetIndex];
+
+        // Give the command of a group record to all of its units at once, which splits them
+        // into selections of 12
+        if ( c.isGroup() )
+        {
+          int start = c.groupStart();
+          if ( start >= data->unitCommandGroupUnitCount )
+            continue;
+          int end = start + 1 + data->unitCommandGroupUnits[start];
+          if ( end > data->unitCommandGroupUnitCount )
+            end = data->unitCommandGroupUnitCount;
+
+          Unitset units;
+          for ( int u = start + 1; u < end; ++u )
+          {
+            int unitIndex = data->unitCommandGroupUnits[u];
+            if ( unitIndex >= 0 && unitIndex < (int)unitVector.size() )
+              units.push_back(unitVector[unitIndex]);
+          }
+          Broodwar->issueCommand(units, UnitCommand(nullptr, c.type, target, c.x, c.y, c.extra));
+          continue;
+        }
 
-        unit->issueCommand(UnitCommand(unit, data->unitCommands[i].type, target, data->unitCommands[i].x, data->unitCommands[i].y, data->unitCommands[i].extra));
+        if (c.unitIndex < 0 || c.unitIndex >= (int)unitVector.size())
+          continue;
+        Unit unit = unitVector[c.unitIndex];
+        unit->issueCommand(UnitCommand(unit, c.type, target, c.x, c.y, c.extra));
       }
     } // if isInGame
   }
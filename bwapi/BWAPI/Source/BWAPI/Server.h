@@ -8,7 +8,10 @@ namespace BWAPI
 {
   // Forwards
   struct GameData;
+  struct StaticGameData;
   struct GameTable;
+  struct UnitData;
+  struct BulletData;
   class Event;
   class ForceInterface;
   typedef ForceInterface *Force;
@@ -25,6 +28,7 @@ namespace BWAPI
     
     void      update();
     bool      isConnected();
+    bool      hasObservers() const;
     int       addEvent(BWAPI::Event e);
     int       addString(const char* text);
     void      clearAll();
@@ -39,21 +43,27 @@ namespace BWAPI
     Unit      getUnit(int id) const;
 
     GameData  *data;
+    StaticGameData *staticData;
   private:
     void onMatchStart();
     void checkForConnections();
     void initializeSharedMemory();
     void updateSharedMemory();
+    void syncUnitData(int id, const UnitData &unitData);
+    void syncBulletData(int id, const BulletData &bulletData);
     void callOnFrame();
     void processCommands();
     void setWaitForResponse(bool wait);
+    void releaseDeadObservers();
     HANDLE pipeObjectHandle;
     HANDLE mapFileHandle;
+    HANDLE staticFileHandle;
     HANDLE gameTableFileHandle;
     GameTable* gameTable;
     int gameTableIndex;
     bool connected;
     bool localOnly;
+    DWORD lastObserverCheck;
     std::vector<Force> forceVector;
     std::map<Force, int> forceLookup;
 
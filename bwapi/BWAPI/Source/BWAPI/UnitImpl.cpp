@@ -112,7 +112,7 @@ namespace BWAPI
     }
 
     // Add to command optimizer if possible, as well as the latency compensation buffer
-    BroodwarImpl.addToCommandBuffer(new Command(command));
+    BroodwarImpl.addToCommandBuffer(command);
     return BroodwarImpl.addToCommandOptimizer(command);
   }
   bool UnitImpl::issueCommand(UnitCommand command)
@@ -137,7 +137,9 @@ namespace BWAPI
       QueueGameCommand(&sel, sel.size);
     }
     else if ( command.type != UnitCommandTypes::Unload || BroodwarImpl.commandOptimizerLevel < 2 )
-      static_cast<UnitImpl*>(command.unit)->orderSelect();   // Unload optimization (no select)
+      static_cast<UnitImpl*>(command.unit)->orderSelect();
+    else  // Unload optimization (no select)
+      BroodwarImpl.commandOptimizerSavedSelects[BroodwarImpl.commandOptimizerLevel]++;
 
     // Immediately execute the command
     BroodwarImpl.executeCommand( command );
@@ -12,6 +12,8 @@ std::string screenshotFmt;
 bool isCorrectVersion = true;
 bool showWarn         = true;
 bool serverEnabled    = true;
+bool deltaSyncEnabled = false;
+bool mapCacheEnabled  = true;
 
 DWORD gdwProcNum = 0;
 
@@ -74,6 +76,12 @@ void InitPrimaryConfig()
   // Check if shared memory should be enabled
   serverEnabled = LoadConfigString("config", "shared_memory", "ON") == "ON";
 
+  // Check if only changed unit/player/bullet data should be published to the client
+  deltaSyncEnabled = LoadConfigString("config", "delta_sync", "OFF") == "ON";
+
+  // Check if the static map data should be cached in bwapi-data\cache
+  mapCacheEnabled = LoadConfigString("config", "map_cache", "ON") == "ON";
+
 /*  // Check if it's time for a holiday
   gdwHoliday = 0;
   if ( LoadConfigString("config", "holiday", "ON") != "OFF" )
@@ -18,5 +18,7 @@ extern std::string screenshotFmt;
 extern bool isCorrectVersion;
 extern bool showWarn;
 extern bool serverEnabled;
+extern bool deltaSyncEnabled;
+extern bool mapCacheEnabled;
 extern DWORD gdwProcNum;
 
@@ -27,6 +27,9 @@ void GameImpl::update()
   //this function is called every frame from a hook attached in DllMain.cpp
   this->inGame = true;
 
+  // Temporaries from the previous frame are no longer in use
+  FrameArena::reset();
+
   // Calculate APM, FPS, etc.
   updateStatistics();
 
@@ -115,6 +118,10 @@ void GameImpl::update()
   this->updateUnits();
   this->updateBullets();
 
+  //pack the tile layers and find the tiles that changed this frame
+  this->map.updateTileLayers();
+  this->placementMap.invalidate(this->map.getTileChanges());
+
   //iterate through the list of intercepted messages
   foreach(std::string i, sentMessages)
     BroodwarImpl.onSendText(i.c_str());
@@ -408,6 +415,11 @@ void GameImpl::updateOverlays()
   {
     setTextSize(Text::Size::Small);
     drawTextScreen(1,1, "%cFrame Rate (Logical Frames)\nLFPS: %d\nAvg LFPS:%.3lf", BWAPI::Text::Yellow, this->getFPS(), this->getAverageFPS());
+    if ( isLatComEnabled() )
+      drawTextScreen(1,40, "%cLatCom: %d buffered, %d replayed", BWAPI::Text::Yellow, commandBuffer.getBufferedCount(), commandBuffer.getReplayedCount());
+    if ( commandOptimizerLevel > 0 )
+      drawTextScreen(1,50, "%cSelects saved by optimizer level 1-4: %u %u %u %u", BWAPI::Text::Yellow,
+                     commandOptimizerSavedSelects[1], commandOptimizerSavedSelects[2], commandOptimizerSavedSelects[3], commandOptimizerSavedSelects[4]);
     setTextSize();
   } // fps
 
@@ -419,132 +431,80 @@ void GameImpl::updateCommandOptimizer()
   // @TODO: Only process on the frame before commands are sent
   //if ( *BW::BWDATA::FramesUntilNextTurn == 1 )
   {
-    // Iterate the command types
-    for ( int i = 0; i < UnitCommandTypes::Enum::None; ++i )
+    // Iterate the buckets, each holds the commands that can be given with a shared selection
+    for ( size_t b = 0; b < commandOptimizerBucketCount; ++b )
     {
-      // Declare our temporary variables
-      Unitset groupOf12;
+      std::vector<UnitCommand> &bucket = commandOptimizer[b];
+      int i = bucket.front().type;
 
-      Position pos  = Positions::None;
-      int       e   = 0;
-      Unit t  = nullptr;
-      UnitType  ut;
-      bool      o   = false;
+      // Units that need the workaround for certain actions must not be grouped with units that
+      // don't, so they get a group of their own
+      Unitset groupOf12[2];
 
-      // Iterate the list
-      auto cmd = commandOptimizer[i].begin();
-      
-      // Re-Iterate all remaining commands
-      while ( cmd != commandOptimizer[i].end() )
+      // Iterate the commands, newest first
+      for ( auto cmd = bucket.rbegin(); cmd != bucket.rend(); ++cmd )
       {
-        // Iterate all commands, and only process those that are equal
-        while ( cmd != commandOptimizer[i].end() )
-        {
-          // Ignore anything but the command that the unit last processed
-          if ( //static_cast<UnitImpl*>(cmd->unit)->lastImmediateCommandFrame == this->getFrameCount() &&
-                  static_cast<UnitImpl*>(cmd->unit)->lastImmediateCommand != *cmd )
-          {
-            cmd = commandOptimizer[i].erase(cmd);
-            continue;
-          }
-
-          // If we are starting a new command grouping
-          if ( groupOf12.empty() )
-          {
-            // Assign our comparison variables to determine which commands should be grouped
-            // Note: Using individual variables instead of comparing UnitCommand operator== because
-            //       it will also compare the type which is not necessary, and we may create a new
-            //       optimization type that does a fuzzy position comparison
-            e = cmd->extra;
-            t = cmd->target;
-            pos = cmd->getTargetPosition();
-            if (  i == UnitCommandTypes::Attack_Unit ||
-                  i == UnitCommandTypes::Unload_All  ||
-                  i == UnitCommandTypes::Load        ||
-                  i == UnitCommandTypes::Cancel_Morph )
-              o = cmd->unit->getType().isBuilding();
-            else if ( i == UnitCommandTypes::Use_Tech )
-              o = cmd->unit->isSieged() || cmd->unit->isCloaked() || cmd->unit->isBurrowed();
-            else
-              o = false;
-            groupOf12.push_back( cmd->unit );
-            cmd = commandOptimizer[i].erase(cmd);
-          } // otherwise if this command is the same as the first, the units can be grouped
-          else if ( e == cmd->extra && t == cmd->target && pos == cmd->getTargetPosition() )
-          {
-            bool oTmp;
-            if (  i == UnitCommandTypes::Attack_Unit ||
-                  i == UnitCommandTypes::Unload_All  ||
-                  i == UnitCommandTypes::Load        ||
-                  i == UnitCommandTypes::Cancel_Morph )
-              oTmp = cmd->unit->getType().isBuilding();
-            else if ( i == UnitCommandTypes::Use_Tech )
-              oTmp = cmd->unit->isSieged() || cmd->unit->isCloaked() || cmd->unit->isBurrowed();
-            else
-              oTmp = false;
-
-            if ( o == oTmp )
-            {
-              groupOf12.push_back( cmd->unit );
-              cmd = commandOptimizer[i].erase(cmd);
-            }
-            else
-              ++cmd;
-          } // otherwise skip this command for now
-          else
-          {
-            ++cmd;
-          }
-
-          // If our group of 12 is full
-          if ( groupOf12.size() == 12 )
-          {
-            // Select the group
-            BW::Orders::Select sel(groupOf12);
-            ++botAPM_select;
-            QueueGameCommand(&sel, sel.size);
-
-            // Workaround for doing certain actions
-            Unit unit = (i == UnitCommandTypes::Load         || 
-                          i == UnitCommandTypes::Attack_Unit  ||
-                          i == UnitCommandTypes::Train        ||
-                          i == UnitCommandTypes::Unload_All   ||
-                          i == UnitCommandTypes::Cancel_Morph ||
-                          i == UnitCommandTypes::Use_Tech) ? groupOf12.front() : nullptr;
-
-            // execute command
-            executeCommand(UnitCommand(unit, i, t, pos.x, pos.y, e));
-            groupOf12.clear();
-          } // groupOf12 max execute
-        } // second while
-
-        // If we iterated the entire command list and don't have an empty group, then give a command
-        // to the remaining units in the group
-        if ( !groupOf12.empty() )
+        // Ignore anything but the command that the unit last processed
+        if ( //static_cast<UnitImpl*>(cmd->unit)->lastImmediateCommandFrame == this->getFrameCount() &&
+                static_cast<UnitImpl*>(cmd->unit)->lastImmediateCommand != *cmd )
+          continue;
+
+        bool o;
+        if (  i == UnitCommandTypes::Attack_Unit ||
+              i == UnitCommandTypes::Unload_All  ||
+              i == UnitCommandTypes::Load        ||
+              i == UnitCommandTypes::Cancel_Morph )
+          o = cmd->unit->getType().isBuilding();
+        else if ( i == UnitCommandTypes::Use_Tech )
+          o = cmd->unit->isSieged() || cmd->unit->isCloaked() || cmd->unit->isBurrowed();
+        else
+          o = false;
+
+        // Add the unit to its group, and give the command once the group of 12 is full
+        Unitset &group = groupOf12[o ? 1 : 0];
+        group.push_back( cmd->unit );
+        if ( group.size() == 12 )
         {
-          // Select the group
-          BW::Orders::Select sel(groupOf12);
-          ++botAPM_select;
-          QueueGameCommand(&sel, sel.size);
-
-          // Workaround for doing certain actions
-          Unit unit = (i == UnitCommandTypes::Load         || 
-                        i == UnitCommandTypes::Attack_Unit  ||
-                        i == UnitCommandTypes::Train        ||
-                        i == UnitCommandTypes::Unload_All   ||
-                        i == UnitCommandTypes::Cancel_Morph ||
-                        i == UnitCommandTypes::Use_Tech) ? groupOf12.front() : nullptr;
-
-          // execute command
-          executeCommand(UnitCommand(unit, i, t, pos.x, pos.y, e));
-          groupOf12.clear();
+          executeCommandGroup(group, bucket.front());
+          group.clear();
         }
-        // Reset iterator
-        cmd = commandOptimizer[i].begin();
-      } // first while
-    } // iterate command types
+      }
+
+      // Give the command to the remaining units in the groups
+      for ( int o = 0; o < 2; ++o )
+      {
+        if ( !groupOf12[o].empty() )
+          executeCommandGroup(groupOf12[o], bucket.front());
+      }
+      bucket.clear();
+    } // iterate buckets
+    commandOptimizerBucketCount = 0;
+    commandOptimizerBuckets.clear();
   } // execute all stored commands
 }
+void GameImpl::executeCommandGroup(const Unitset &group, const UnitCommand &command)
+{
+  // Select the group
+  BW::Orders::Select sel(group);
+  ++botAPM_select;
+  QueueGameCommand(&sel, sel.size);
+
+  // Every unit past the first would have needed a selection of its own
+  commandOptimizerSavedSelects[commandOptimizerLevel] += group.size() - 1;
+
+  // Workaround for doing certain actions
+  int i = command.type;
+  Unit unit = (i == UnitCommandTypes::Load         || 
+                i == UnitCommandTypes::Attack_Unit  ||
+                i == UnitCommandTypes::Train        ||
+                i == UnitCommandTypes::Unload_All   ||
+                i == UnitCommandTypes::Cancel_Morph ||
+                i == UnitCommandTypes::Use_Tech) ? group.front() : nullptr;
+
+  // execute command
+  Position pos = command.getTargetPosition();
+  executeCommand(UnitCommand(unit, i, command.target, pos.x, pos.y, command.extra));
+}
 
 //--------------------------------------------- TOURNAMENT MODULE ----------------------------------------------
 void GameImpl::initializeTournamentModule()
@@ -1,26 +1,261 @@
 #include <BWAPI/Client/Client.h>
-#include <windows.h>
 #include <sstream>
 #include <iostream>
 #include <cassert>
+#include <BWAPI/Client/FrameHandoff.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#endif
 
 namespace BWAPI
 {
   Client BWAPIClient;
+  // Observers that crashed or were killed never release their slot
+  static bool isProcessRunning(unsigned int processID)
+  {
+#ifdef _WIN32
+    HANDLE process = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processID);
+    if ( !process )
+      return GetLastError() == ERROR_ACCESS_DENIED;
+    DWORD exitCode = 0;
+    bool running = GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+    CloseHandle(process);
+    return running;
+#else
+    return kill((pid_t)processID, 0) == 0 || errno == EPERM;
+#endif
+  }
+  bool Client::isConnected()
+  {
+    return this->connected;
+  }
+  bool Client::isObserver() const
+  {
+    return this->observerSlot != -1;
+  }
+  unsigned int Client::getFrameSequence() const
+  {
+    return this->lastFrameSequence;
+  }
+  bool Client::isFrameValid() const
+  {
+    return !this->isObserver() || data->frameLock == this->frameLockAtUpdate;
+  }
+  void Client::setSpinIterations(int iterations)
+  {
+    this->spinIterations = iterations;
+  }
+  int Client::getSpinIterations() const
+  {
+    return this->spinIterations;
+  }
+  unsigned int Client::getSpinHandoffCount() const
+  {
+    return this->spinHandoffCount;
+  }
+  unsigned int Client::getBlockingHandoffCount() const
+  {
+    return this->blockingHandoffCount;
+  }
+  bool Client::spinForFrame()
+  {
+    for ( int i = 0; i < spinIterations; ++i )
+    {
+      unsigned int seq = loadSequence(&data->frameSequence);
+      if ( seq != lastFrameSequence )
+      {
+        lastFrameSequence = seq;
+        ++spinHandoffCount;
+        return true;
+      }
+#if defined(_WIN32)
+      YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+      __builtin_ia32_pause();
+#endif
+    }
+    ++blockingHandoffCount;
+    return false;
+  }
+  bool Client::claimObserverSlot()
+  {
+#ifdef _WIN32
+    unsigned int processID = GetCurrentProcessId();
+#else
+    unsigned int processID = getpid();
+#endif
+    // Prefer instances that already have a bot connected, then any running server
+    for ( int pass = 0; pass < 2; ++pass )
+    {
+      for ( int i = 0; i < GameTable::MAX_GAME_INSTANCES; ++i )
+      {
+        GameInstance &instance = gameTable->gameInstances[i];
+        if ( instance.serverProcessID == 0 || (pass == 0 && !instance.isConnected) )
+          continue;
+        for ( int slot = 0; slot < GameInstance::MAX_OBSERVERS; ++slot )
+        {
+          unsigned int owner = instance.observerProcessIDs[slot];
+          if ( owner != 0 && !isProcessRunning(owner) )
+          {
+#ifdef _WIN32
+            InterlockedCompareExchange((volatile LONG*)&instance.observerProcessIDs[slot], 0, owner);
+#else
+            __sync_bool_compare_and_swap(&instance.observerProcessIDs[slot], owner, 0u);
+#endif
+          }
+#ifdef _WIN32
+          bool claimed = InterlockedCompareExchange((volatile LONG*)&instance.observerProcessIDs[slot], processID, 0) == 0;
+#else
+          bool claimed = __sync_bool_compare_and_swap(&instance.observerProcessIDs[slot], 0u, processID);
+#endif
+          if ( claimed )
+          {
+            gameTableIndex = i;
+            observerSlot   = slot;
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+  void Client::releaseObserverSlot()
+  {
+    if ( gameTable && gameTableIndex != -1 && observerSlot != -1 )
+      gameTable->gameInstances[gameTableIndex].observerProcessIDs[observerSlot] = 0;
+    observerSlot = -1;
+  }
+  bool Client::startMatch()
+  {
+    // The server bumps the generation when it writes the static data of a new match. A mapping
+    // that does not have it belongs to an earlier match, map the section again.
+    if ( staticData->generation != data->staticGeneration )
+    {
+      unmapStaticData();
+      if ( !mapStaticData(gameTable->gameInstances[gameTableIndex].serverProcessID) )
+      {
+        std::cout << "failed, disconnecting" << std::endl;
+        disconnect();
+        return false;
+      }
+      if ( staticData->generation != data->staticGeneration )
+        std::cerr << "Static game data generation " << staticData->generation << " does not match " << data->staticGeneration << std::endl;
+    }
+    GameImpl *game = static_cast<GameImpl*>(BWAPI::BroodwarPtr);
+    game->setStaticGameData(staticData);
+    game->onMatchStart();
+    return true;
+  }
+  void Client::updateObserver()
+  {
+    // Wait for a frame that the server has finished writing, the server never waits for us
+    unsigned int lock, seq;
+    for (;;)
+    {
+      lock = data->frameLock;
+      seq  = data->frameSequence;
+      if ( !(lock & 1) && seq != lastFrameSequence && lock == data->frameLock )
+        break;
+      if ( !waitForServer() )
+      {
+        std::cout << "failed, disconnecting" << std::endl;
+        disconnect();
+        return;
+      }
+    }
+
+    // If frames were skipped (or torn) the discover/evade events for them were lost,
+    // so rebuild the unit sets from the unit data instead
+    GameImpl *game = static_cast<GameImpl*>(BWAPI::BroodwarPtr);
+    if ( resyncObserver || seq - lastFrameSequence != 1 )
+    {
+      if ( data->isInGame && !game->inGame && !startMatch() )
+        return;
+      if ( game->inGame )
+        game->resyncUnits();
+    }
+    lastFrameSequence = seq;
+    frameLockAtUpdate = lock;
+    processEvents();
+    resyncObserver = !isFrameValid();
+  }
+  void Client::processEvents()
+  {
+    for(int i = 0; i < data->eventCount; ++i)
+    {
+      EventType::Enum type(data->events[i].type);
+
+      if ( type == EventType::MatchStart && !startMatch() )
+        return;
+      if ( type == EventType::MatchFrame || type == EventType::MenuFrame )
+        static_cast<GameImpl*>(BWAPI::BroodwarPtr)->onMatchFrame();
+    }
+    if ( BWAPI::BroodwarPtr != nullptr && static_cast<GameImpl*>(BWAPI::BroodwarPtr)->inGame && !Broodwar->isInGame() )
+      static_cast<GameImpl*>(BWAPI::BroodwarPtr)->onMatchEnd();
+  }
+}
+
+#ifdef _WIN32
+namespace BWAPI
+{
   Client::Client()
     : data(nullptr)
+    , staticData(nullptr)
     , pipeObjectHandle(INVALID_HANDLE_VALUE)
     , mapFileHandle(INVALID_HANDLE_VALUE)
+    , staticFileHandle(INVALID_HANDLE_VALUE)
     , gameTableFileHandle(INVALID_HANDLE_VALUE)
+    , unreadFrameCodes(0)
+    , gameTable(nullptr)
+    , gameTableIndex(-1)
+    , observerSlot(-1)
+    , lastFrameSequence(0)
+    , frameLockAtUpdate(0)
+    , resyncObserver(false)
+    , spinIterations(0)
+    , spinHandoffCount(0)
+    , blockingHandoffCount(0)
     , connected(false)
   {}
   Client::~Client()
   {
     this->disconnect();
   }
-  bool Client::isConnected()
+  //------------------------------------------- MAP STATIC DATA ----------------------------------------------
+  bool Client::mapStaticData(int serverProcID)
   {
-    return this->connected;
+    std::stringstream staticMemoryName;
+    staticMemoryName << "Local\\bwapi_shared_memory_static_";
+    staticMemoryName << serverProcID;
+
+    // Only the server writes the static data, every client maps it read-only
+    staticFileHandle = OpenFileMapping(FILE_MAP_READ, FALSE, staticMemoryName.str().c_str());
+    if (staticFileHandle == INVALID_HANDLE_VALUE || staticFileHandle == NULL)
+    {
+      std::cerr << "Unable to open shared memory mapping: " << staticMemoryName.str() << std::endl;
+      staticFileHandle = INVALID_HANDLE_VALUE;
+      return false;
+    }
+    staticData = (const StaticGameData*) MapViewOfFile(staticFileHandle, FILE_MAP_READ, 0, 0, sizeof(StaticGameData));
+    if ( staticData == nullptr )
+    {
+      std::cerr << "Unable to map static game data." << std::endl;
+      return false;
+    }
+    return true;
+  }
+  void Client::unmapStaticData()
+  {
+    if ( staticData )
+      UnmapViewOfFile(staticData);
+    staticData = nullptr;
+
+    if ( staticFileHandle != INVALID_HANDLE_VALUE )
+      CloseHandle(staticFileHandle);
+    staticFileHandle = INVALID_HANDLE_VALUE;
   }
   bool Client::connect()
   {
@@ -31,7 +266,7 @@ namespace BWAPI
     }
 
     int serverProcID    = -1;
-    int gameTableIndex  = -1;
+    gameTableIndex      = -1;
 
     this->gameTable = NULL;
     this->gameTableFileHandle = OpenFileMapping(FILE_MAP_WRITE | FILE_MAP_READ, FALSE, "Local\\bwapi_shared_memory_game_list" );
@@ -110,11 +345,13 @@ namespace BWAPI
       std::cerr << "Unable to map game data." << std::endl;
       return false;
     }
+    if ( !mapStaticData(serverProcID) )
+      return false;
 
     // Create new instance of Game/Broodwar
     if ( BWAPI::BroodwarPtr )
       delete static_cast<GameImpl*>(BWAPI::BroodwarPtr);
-    BWAPI::BroodwarPtr = new GameImpl(data);
+    BWAPI::BroodwarPtr = new GameImpl(data, staticData);
     assert( BWAPI::BroodwarPtr != nullptr );
 
     if (BWAPI::BWAPI_getRevision() != BWAPI::Broodwar->getRevision())
@@ -141,15 +378,110 @@ namespace BWAPI
       }
     }
     
+    lastFrameSequence = data->frameSequence;
+    unreadFrameCodes  = 0;
+
     std::cout << "Connection successful" << std::endl;
     assert( BWAPI::BroodwarPtr != nullptr);
 
     this->connected = true;
     return true;
   }
+  bool Client::connectAsObserver()
+  {
+    if ( this->connected )
+    {
+      std::cout << "Already connected." << std::endl;
+      return true;
+    }
+
+    this->gameTable = NULL;
+    this->gameTableFileHandle = OpenFileMapping(FILE_MAP_WRITE | FILE_MAP_READ, FALSE, "Local\\bwapi_shared_memory_game_list" );
+    if ( !this->gameTableFileHandle )
+    {
+      std::cerr << "Game table mapping not found." << std::endl;
+      return false;
+    }
+    this->gameTable = (GameTable*)MapViewOfFile(this->gameTableFileHandle, FILE_MAP_WRITE | FILE_MAP_READ, 0, 0, sizeof(GameTable));
+    if ( !this->gameTable )
+    {
+      std::cerr << "Unable to map Game table." << std::endl;
+      return false;
+    }
+
+    if ( !claimObserverSlot() )
+    {
+      std::cerr << "No free observer slot" << std::endl;
+      CloseHandle(gameTableFileHandle);
+      return false;
+    }
+
+    std::stringstream sharedMemoryName;
+    sharedMemoryName << "Local\\bwapi_shared_memory_";
+    sharedMemoryName << gameTable->gameInstances[gameTableIndex].serverProcessID;
+
+    // Observers only get read access to the game data
+    mapFileHandle = OpenFileMapping(FILE_MAP_READ, FALSE, sharedMemoryName.str().c_str());
+    if (mapFileHandle == INVALID_HANDLE_VALUE || mapFileHandle == NULL)
+    {
+      std::cerr << "Unable to open shared memory mapping: " << sharedMemoryName.str() << std::endl;
+      releaseObserverSlot();
+      CloseHandle(gameTableFileHandle);
+      return false;
+    }
+    data = (GameData*) MapViewOfFile(mapFileHandle, FILE_MAP_READ, 0, 0, sizeof(GameData));
+    if ( data == nullptr )
+    {
+      std::cerr << "Unable to map game data." << std::endl;
+      releaseObserverSlot();
+      return false;
+    }
+    if ( !mapStaticData(gameTable->gameInstances[gameTableIndex].serverProcessID) )
+    {
+      releaseObserverSlot();
+      return false;
+    }
+
+    // Create new instance of Game/Broodwar
+    if ( BWAPI::BroodwarPtr )
+      delete static_cast<GameImpl*>(BWAPI::BroodwarPtr);
+    BWAPI::BroodwarPtr = new GameImpl(data, staticData);
+    assert( BWAPI::BroodwarPtr != nullptr );
+    static_cast<GameImpl*>(BWAPI::BroodwarPtr)->readOnly = true;
+
+    // Mark the connection before checking the revision so that disconnect can release the slot
+    this->connected = true;
+    if (BWAPI::BWAPI_getRevision() != BWAPI::Broodwar->getRevision())
+    {
+      //error
+      std::cerr << "Error: Client and Server are not compatible!" << std::endl;
+      std::cerr << "Client Revision: " << BWAPI::BWAPI_getRevision() << std::endl;
+      std::cerr << "Server Revision: " << BWAPI::Broodwar->getRevision() << std::endl;
+      disconnect();
+      Sleep(2000);
+      return false;
+    }
+
+    // The first frame we pick up needs a full rebuild
+    lastFrameSequence = data->frameSequence;
+    resyncObserver    = true;
+
+    std::cout << "Observer connection successful" << std::endl;
+    return true;
+  }
+  bool Client::waitForServer()
+  {
+    // Consider the server gone if it stopped updating its keep alive time
+    if ( GetTickCount() - gameTable->gameInstances[gameTableIndex].lastKeepAliveTime > 5000 )
+      return false;
+    Sleep(1);
+    return true;
+  }
   void Client::disconnect()
   {
     if ( !this->connected ) return;
+
+    releaseObserverSlot();
     
     if ( gameTableFileHandle != INVALID_HANDLE_VALUE )
       CloseHandle(gameTableFileHandle);
@@ -163,6 +495,8 @@ namespace BWAPI
       CloseHandle(mapFileHandle);
     mapFileHandle = INVALID_HANDLE_VALUE;
 
+    unmapStaticData();
+
     this->connected = false;
     std::cout << "Disconnected" << std::endl;
 
@@ -172,11 +506,49 @@ namespace BWAPI
   }
   void Client::update()
   {
+    // Temporaries from the previous frame are no longer in use
+    FrameArena::reset();
+
+    if ( isObserver() )
+    {
+      updateObserver();
+      return;
+    }
+
+    // A draw list left open by the bot is closed with the frame, as the server does for AI modules
+    static_cast<GameImpl*>(BWAPI::BroodwarPtr)->endDrawList();
+
     DWORD writtenByteCount;
     int code = 1;
     WriteFile(pipeObjectHandle, &code, sizeof(code), &writtenByteCount, NULL);
     //std::cout << "wrote to pipe" << std::endl;
 
+    // The server still writes a code for frames that were picked up by spinning, consume those
+    // first (they are already in the pipe, or about to be) so they aren't mistaken for the next frame
+    for ( ; unreadFrameCodes > 0; --unreadFrameCodes )
+    {
+      code = 1;
+      while (code != 2)
+      {
+        DWORD receivedByteCount;
+        BOOL success = ReadFile(pipeObjectHandle, &code, sizeof(code), &receivedByteCount, NULL);
+        if ( !success )
+        {
+          std::cout << "failed, disconnecting" << std::endl;
+          disconnect();
+          return;
+        }
+      }
+    }
+
+    if ( spinForFrame() )
+    {
+      ++unreadFrameCodes;
+      processEvents();
+      return;
+    }
+
+    code = 1;
     while (code != 2)
     {
       DWORD receivedByteCount;
@@ -189,18 +561,9 @@ namespace BWAPI
         return;
       }
     }
+    lastFrameSequence = data->frameSequence;
     //std::cout << "about to enter event loop" << std::endl;
-
-    for(int i = 0; i < data->eventCount; ++i)
-    {
-      EventType::Enum type(data->events[i].type);
-
-      if ( type == EventType::MatchStart )
-        static_cast<GameImpl*>(BWAPI::BroodwarPtr)->onMatchStart();
-      if ( type == EventType::MatchFrame || type == EventType::MenuFrame )
-        static_cast<GameImpl*>(BWAPI::BroodwarPtr)->onMatchFrame();
-    }
-    if ( BWAPI::BroodwarPtr != nullptr && static_cast<GameImpl*>(BWAPI::BroodwarPtr)->inGame && !Broodwar->isInGame() )
-      static_cast<GameImpl*>(BWAPI::BroodwarPtr)->onMatchEnd();
+    processEvents();
   }
 }
+#endif
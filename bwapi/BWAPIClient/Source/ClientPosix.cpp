@@ -0,0 +1,330 @@
+#include <BWAPI/Client/Client.h>
+#include <sstream>
+#include <iostream>
+#include <cassert>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <BWAPI/Client/FrameHandoff.h>
+
+namespace BWAPI
+{
+  // Time to wait for the server before checking if it is still alive
+  #define FRAME_WAIT_TIMEOUT_MS 2000
+
+  //------------------------------------------ MAP SHARED MEMORY ---------------------------------------------
+  static void *mapSharedMemory(const char *name, size_t size, bool readOnly = false)
+  {
+    int fd = shm_open(name, readOnly ? O_RDONLY : O_RDWR, 0);
+    if ( fd == -1 )
+      return nullptr;
+    void *mem = mmap(nullptr, size, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return mem == MAP_FAILED ? nullptr : mem;
+  }
+
+  Client::Client()
+    : data(nullptr)
+    , staticData(nullptr)
+    , gameTable(nullptr)
+    , gameTableIndex(-1)
+    , observerSlot(-1)
+    , lastFrameSequence(0)
+    , frameLockAtUpdate(0)
+    , resyncObserver(false)
+    , spinIterations(0)
+    , spinHandoffCount(0)
+    , blockingHandoffCount(0)
+    , connected(false)
+  {}
+  Client::~Client()
+  {
+    this->disconnect();
+  }
+  //------------------------------------------- MAP STATIC DATA ----------------------------------------------
+  bool Client::mapStaticData(int serverProcID)
+  {
+    std::stringstream staticMemoryName;
+    staticMemoryName << "/bwapi_shared_memory_static_";
+    staticMemoryName << serverProcID;
+
+    // Only the server writes the static data, every client maps it read-only
+    staticData = (const StaticGameData*)mapSharedMemory(staticMemoryName.str().c_str(), sizeof(StaticGameData), true);
+    if ( staticData == nullptr )
+    {
+      std::cerr << "Unable to open shared memory mapping: " << staticMemoryName.str() << std::endl;
+      return false;
+    }
+    return true;
+  }
+  void Client::unmapStaticData()
+  {
+    if ( staticData )
+      munmap((void*)staticData, sizeof(StaticGameData));
+    staticData = nullptr;
+  }
+  bool Client::connect()
+  {
+    if ( this->connected )
+    {
+      std::cout << "Already connected." << std::endl;
+      return true;
+    }
+
+    int serverProcID = -1;
+    gameTableIndex   = -1;
+
+    this->gameTable = (GameTable*)mapSharedMemory("/bwapi_shared_memory_game_list", sizeof(GameTable));
+    if ( !this->gameTable )
+    {
+      std::cerr << "Game table mapping not found." << std::endl;
+      return false;
+    }
+
+    //Find row with most recent keep alive that isn't connected
+    unsigned int latest = 0;
+    for(int i = 0; i < GameTable::MAX_GAME_INSTANCES; i++)
+    {
+      std::cout << i << " | " << gameTable->gameInstances[i].serverProcessID << " | " << gameTable->gameInstances[i].isConnected << " | " << gameTable->gameInstances[i].lastKeepAliveTime << std::endl;
+      if (gameTable->gameInstances[i].serverProcessID != 0 && !gameTable->gameInstances[i].isConnected)
+      {
+        if ( gameTableIndex == -1 || latest == 0 || gameTable->gameInstances[i].lastKeepAliveTime < latest )
+        {
+          latest = gameTable->gameInstances[i].lastKeepAliveTime;
+          gameTableIndex = i;
+        }
+      }
+    }
+
+    if (gameTableIndex != -1)
+      serverProcID = gameTable->gameInstances[gameTableIndex].serverProcessID;
+
+    if (serverProcID == -1)
+    {
+      std::cerr << "No server proc ID" << std::endl;
+      munmap(gameTable, sizeof(GameTable));
+      gameTable = nullptr;
+      return false;
+    }
+
+    std::stringstream sharedMemoryName;
+    sharedMemoryName << "/bwapi_shared_memory_";
+    sharedMemoryName << serverProcID;
+
+    data = (GameData*)mapSharedMemory(sharedMemoryName.str().c_str(), sizeof(GameData));
+    if ( data == nullptr )
+    {
+      std::cerr << "Unable to open shared memory mapping: " << sharedMemoryName.str() << std::endl;
+      munmap(gameTable, sizeof(GameTable));
+      gameTable = nullptr;
+      return false;
+    }
+    if ( !mapStaticData(serverProcID) )
+    {
+      munmap(data, sizeof(GameData));
+      data = nullptr;
+      munmap(gameTable, sizeof(GameTable));
+      gameTable = nullptr;
+      return false;
+    }
+    std::cout << "Connected" << std::endl;
+
+    // Create new instance of Game/Broodwar
+    if ( BWAPI::BroodwarPtr )
+      delete static_cast<GameImpl*>(BWAPI::BroodwarPtr);
+    BWAPI::BroodwarPtr = new GameImpl(data, staticData);
+    assert( BWAPI::BroodwarPtr != nullptr );
+
+    // Mark the connection before checking the revision so that disconnect can release the mappings
+    this->connected = true;
+    if (BWAPI::BWAPI_getRevision() != BWAPI::Broodwar->getRevision())
+    {
+      //error
+      std::cerr << "Error: Client and Server are not compatible!" << std::endl;
+      std::cerr << "Client Revision: " << BWAPI::BWAPI_getRevision() << std::endl;
+      std::cerr << "Server Revision: " << BWAPI::Broodwar->getRevision() << std::endl;
+      disconnect();
+      sleep(2);
+      return false;
+    }
+
+    // Claim the instance and acknowledge everything the server has published so far
+    gameTable->gameInstances[gameTableIndex].isConnected = true;
+    lastFrameSequence = loadSequence(&data->frameSequence);
+    setSequence(&data->clientSequence, lastFrameSequence);
+
+    //wait for permission from server before we resume execution
+    while ( !waitForSequence(&data->frameSequence, lastFrameSequence, FRAME_WAIT_TIMEOUT_MS) )
+    {
+      if ( kill(serverProcID, 0) == -1 && errno == ESRCH )
+      {
+        std::cerr << "Server process is gone." << std::endl;
+        disconnect();
+        return false;
+      }
+    }
+    lastFrameSequence = loadSequence(&data->frameSequence);
+
+    std::cout << "Connection successful" << std::endl;
+    assert( BWAPI::BroodwarPtr != nullptr);
+    return true;
+  }
+  bool Client::connectAsObserver()
+  {
+    if ( this->connected )
+    {
+      std::cout << "Already connected." << std::endl;
+      return true;
+    }
+
+    gameTableIndex = -1;
+    this->gameTable = (GameTable*)mapSharedMemory("/bwapi_shared_memory_game_list", sizeof(GameTable));
+    if ( !this->gameTable )
+    {
+      std::cerr << "Game table mapping not found." << std::endl;
+      return false;
+    }
+
+    if ( !claimObserverSlot() )
+    {
+      std::cerr << "No free observer slot" << std::endl;
+      munmap(gameTable, sizeof(GameTable));
+      gameTable = nullptr;
+      return false;
+    }
+
+    std::stringstream sharedMemoryName;
+    sharedMemoryName << "/bwapi_shared_memory_";
+    sharedMemoryName << gameTable->gameInstances[gameTableIndex].serverProcessID;
+
+    // Observers only get read access to the game data
+    data = (GameData*)mapSharedMemory(sharedMemoryName.str().c_str(), sizeof(GameData), true);
+    if ( data == nullptr )
+    {
+      std::cerr << "Unable to open shared memory mapping: " << sharedMemoryName.str() << std::endl;
+      releaseObserverSlot();
+      munmap(gameTable, sizeof(GameTable));
+      gameTable = nullptr;
+      return false;
+    }
+    if ( !mapStaticData(gameTable->gameInstances[gameTableIndex].serverProcessID) )
+    {
+      releaseObserverSlot();
+      munmap(data, sizeof(GameData));
+      data = nullptr;
+      munmap(gameTable, sizeof(GameTable));
+      gameTable = nullptr;
+      return false;
+    }
+
+    // Create new instance of Game/Broodwar
+    if ( BWAPI::BroodwarPtr )
+      delete static_cast<GameImpl*>(BWAPI::BroodwarPtr);
+    BWAPI::BroodwarPtr = new GameImpl(data, staticData);
+    assert( BWAPI::BroodwarPtr != nullptr );
+    static_cast<GameImpl*>(BWAPI::BroodwarPtr)->readOnly = true;
+
+    this->connected = true;
+    if (BWAPI::BWAPI_getRevision() != BWAPI::Broodwar->getRevision())
+    {
+      //error
+      std::cerr << "Error: Client and Server are not compatible!" << std::endl;
+      std::cerr << "Client Revision: " << BWAPI::BWAPI_getRevision() << std::endl;
+      std::cerr << "Server Revision: " << BWAPI::Broodwar->getRevision() << std::endl;
+      disconnect();
+      sleep(2);
+      return false;
+    }
+
+    // The first frame we pick up needs a full rebuild
+    lastFrameSequence = loadSequence(&data->frameSequence);
+    resyncObserver    = true;
+
+    std::cout << "Observer connection successful" << std::endl;
+    return true;
+  }
+  bool Client::waitForServer()
+  {
+    // A frame is already out, the server is just rewriting the next one
+    if ( loadSequence(&data->frameSequence) != lastFrameSequence )
+    {
+      sched_yield();
+      return true;
+    }
+    if ( waitForSequence(&data->frameSequence, lastFrameSequence, FRAME_WAIT_TIMEOUT_MS) )
+      return true;
+    unsigned int serverProcID = gameTable->gameInstances[gameTableIndex].serverProcessID;
+    return serverProcID != 0 && !(kill(serverProcID, 0) == -1 && errno == ESRCH);
+  }
+  void Client::disconnect()
+  {
+    if ( !this->connected ) return;
+
+    releaseObserverSlot();
+    if ( gameTable )
+    {
+      if ( gameTableIndex != -1 )
+        gameTable->gameInstances[gameTableIndex].isConnected = false;
+      munmap(gameTable, sizeof(GameTable));
+    }
+    gameTable = nullptr;
+    gameTableIndex = -1;
+
+    if ( data )
+      munmap(data, sizeof(GameData));
+    data = nullptr;
+
+    unmapStaticData();
+
+    this->connected = false;
+    std::cout << "Disconnected" << std::endl;
+
+    if ( BWAPI::BroodwarPtr )
+      delete static_cast<GameImpl*>(BWAPI::BroodwarPtr);
+    BWAPI::BroodwarPtr = nullptr;
+  }
+  void Client::update()
+  {
+    // Temporaries from the previous frame are no longer in use
+    FrameArena::reset();
+
+    if ( isObserver() )
+    {
+      updateObserver();
+      return;
+    }
+
+    // A draw list left open by the bot is closed with the frame, as the server does for AI modules
+    static_cast<GameImpl*>(BWAPI::BroodwarPtr)->endDrawList();
+
+    // Tell the server we are done with the current frame
+    setSequence(&data->clientSequence, lastFrameSequence);
+
+    // Wait for the next one
+    if ( spinForFrame() )
+    {
+      processEvents();
+      return;
+    }
+    while ( !waitForSequence(&data->frameSequence, lastFrameSequence, FRAME_WAIT_TIMEOUT_MS) )
+    {
+      unsigned int serverProcID = gameTable->gameInstances[gameTableIndex].serverProcessID;
+      if ( serverProcID == 0 || (kill(serverProcID, 0) == -1 && errno == ESRCH) )
+      {
+        std::cout << "failed, disconnecting" << std::endl;
+        disconnect();
+        return;
+      }
+    }
+    lastFrameSequence = loadSequence(&data->frameSequence);
+    processEvents();
+  }
+}
+#endif
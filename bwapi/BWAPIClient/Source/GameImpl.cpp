@@ -14,12 +14,24 @@
 #include <string>
 #include <cassert>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#define MAX_PATH 260
+#endif
+
 #include <BWAPI/Unitset.h>
 
 namespace BWAPI
 {
-  GameImpl::GameImpl(GameData* _data)
+  GameImpl::GameImpl(GameData* _data, const StaticGameData* _staticData)
     : data(_data)
+    , staticData(_staticData)
+    , recordingDrawList(-1)
+    , finderGeneration(0)
+    , finderDepth(0)
+    , readOnly(false)
   {
     this->clearAll();
     for(int i = 0; i < 5; ++i)
@@ -35,33 +47,56 @@ namespace BWAPI
   }
   int GameImpl::addShape(const BWAPIC::Shape &s)
   {
+    if ( readOnly )
+      return -1;
     assert(data->shapeCount < GameData::MAX_SHAPES);
     data->shapes[data->shapeCount] = s;
     return data->shapeCount++;
   }
   int GameImpl::addString(const char* text)
   {
-    assert(data->stringCount < GameData::MAX_STRINGS);
-    StrCopy(data->strings[data->stringCount], text);
-    return data->stringCount++;
+    if ( readOnly )
+      return -1;
+    int handle = data->strings.add(text);
+    assert(handle != -1);
+    return handle;
   }
   int GameImpl::addText(BWAPIC::Shape &s, const char* text)
   {
-    s.extra1 = addString(text);
+    if ( readOnly )
+      return -1;
+    // Overlays draw the same labels over and over, store each one once per frame
+    s.extra1 = textInterner.add(data->strings, text);
+    assert(s.extra1 != -1);
     return addShape(s);
   }
   int GameImpl::addCommand(const BWAPIC::Command &c)
   {
+    if ( readOnly )
+      return -1;
     assert(data->commandCount < GameData::MAX_COMMANDS);
     data->commands[data->commandCount] = c;
     return data->commandCount++;
   }
   int GameImpl::addUnitCommand(BWAPIC::UnitCommand& c)
   {
+    if ( readOnly )
+      return -1;
     assert(data->unitCommandCount < GameData::MAX_UNIT_COMMANDS);
     data->unitCommands[data->unitCommandCount] = c;
     return data->unitCommandCount++;
   }
+  int GameImpl::addUnitCommandGroup(BWAPIC::UnitCommand& c, const std::vector<int> &unitIndices)
+  {
+    if ( readOnly )
+      return -1;
+    assert(data->unitCommandGroupUnitCount + 1 + (int)unitIndices.size() <= GameData::MAX_UNIT_COMMAND_GROUP_UNITS);
+    c.setGroup(data->unitCommandGroupUnitCount);
+    data->unitCommandGroupUnits[data->unitCommandGroupUnitCount++] = unitIndices.size();
+    for ( auto i = unitIndices.begin(); i != unitIndices.end(); ++i )
+      data->unitCommandGroupUnits[data->unitCommandGroupUnitCount++] = *i;
+    return addUnitCommand(c);
+  }
   Unit GameImpl::_unitFromIndex(int index)
   {
     return this->getUnit(index);
@@ -77,11 +112,11 @@ namespace BWAPI
     if (e.type == EventType::PlayerLeft)
       e2.setPlayer(getPlayer(e.v1));
     if (e.type == EventType::SaveGame || e.type == EventType::SendText)
-      e2.setText(data->eventStrings[e.v1]);
+      e2.setText(data->eventStrings.get(e.v1));
     if (e.type == EventType::ReceiveText)
     {
       e2.setPlayer(getPlayer(e.v1));
-      e2.setText(data->eventStrings[e.v2]);
+      e2.setText(data->eventStrings.get(e.v2));
     }
     if (e.type == EventType::UnitDiscover ||
         e.type == EventType::UnitEvade ||
@@ -113,17 +148,24 @@ namespace BWAPI
     staticNeutralUnits.clear();
     selectedUnits.clear();
     pylons.clear();
+    powerGrid.clear();
     events.clear();
+    unitGrid.invalidate();
     thePlayer  = NULL;
     theEnemy   = NULL;
     theNeutral = NULL;
     _allies.clear();
     _enemies.clear();
     _observers.clear();
+    hasFrameBaseline = false;
 
     //clear unit data
     for ( size_t i = 0; i < unitVector.size(); ++i )
+    {
       unitVector[i].clear();
+      unitVector[i].connectedTo = nullptr;
+      unitVector[i].loadedInto  = nullptr;
+    }
 
     //clear player data
     for(size_t i = 0; i < playerVector.size(); ++i)
@@ -133,6 +175,15 @@ namespace BWAPI
       delete r;
     regionsList.clear();
     memset(this->regionArray, 0, sizeof(this->regionArray));
+    groundDistances.clear();
+    walkTileRegions.clear();
+    regionNeighborOffsets.clear();
+    regionNeighbors.clear();
+    clearance.clear();
+    for ( int i = 0; i < 3; ++i )
+      clearanceAreas[i].clear();
+    drawListNames.clear();
+    recordingDrawList = -1;
   }
 
   //------------------------------------------- INTERFACE EVENT UPDATE ---------------------------------------
@@ -166,6 +217,10 @@ namespace BWAPI
       p->updateEvents();
   }
   //------------------------------------------------- ON MATCH START -----------------------------------------
+  void GameImpl::setStaticGameData(const StaticGameData* _staticData)
+  {
+    staticData = _staticData;
+  }
   void GameImpl::onMatchStart()
   {
     clearAll();
@@ -184,16 +239,27 @@ namespace BWAPI
     }
 
     //load start locations from shared memory
-    for(int i = 0; i < data->startLocationCount; ++i)
-      startLocations.push_back(BWAPI::TilePosition(data->startLocations[i].x,data->startLocations[i].y));
+    for(int i = 0; i < staticData->startLocationCount; ++i)
+      startLocations.push_back(BWAPI::TilePosition(staticData->startLocations[i].x,staticData->startLocations[i].y));
 
-    for ( int i = 0; i < data->regionCount; ++i )
+    //load the region adjacency
+    const int *neighborOffsets = staticData->regionNeighborOffsets;
+    regionNeighborOffsets.assign(neighborOffsets, neighborOffsets + staticData->regionCount + 1);
+    regionNeighbors.assign(staticData->regionNeighbors, staticData->regionNeighbors + neighborOffsets[staticData->regionCount]);
+
+    for ( int i = 0; i < staticData->regionCount; ++i )
     {
       this->regionArray[i] = new RegionImpl(i);
       regionsList.insert(this->regionArray[i]);
     }
-    for ( int i = 0; i < data->regionCount; ++i )
+    for ( int i = 0; i < staticData->regionCount; ++i )
       this->regionArray[i]->setNeighbors();
+    this->_computeWalkTileRegions();
+
+    //compute the clearance of each mini-tile from the walkability
+    this->_computeClearance();
+    this->placementMap.reset(data->mapWidth, data->mapHeight);
+    this->powerGrid.reset(data->mapWidth, data->mapHeight);
 
     thePlayer  = getPlayer(data->self);
     theEnemy   = getPlayer(data->enemy);
@@ -235,12 +301,29 @@ namespace BWAPI
   //------------------------------------------------- ON MATCH FRAME -----------------------------------------
   void GameImpl::onMatchFrame()
   {
+    // The server's change lists can only be used once the sets have been fully built for this match
+    bool useFrameDelta = data->hasFrameDelta && hasFrameBaseline;
+
     events.clear();
-    bullets.clear();
-    for(int i = 0; i < 100; ++i)
+    if ( useFrameDelta )
+    {
+      for ( int i = 0; i < data->changedBulletCount; ++i )
+      {
+        Bullet b = &bulletVector[data->changedBullets[i]];
+        if ( b->exists() )
+          bullets.insert(b);
+        else
+          bullets.erase(b);
+      }
+    }
+    else
     {
-      if (bulletVector[i].exists())
-        bullets.insert(&bulletVector[i]);
+      bullets.clear();
+      for(int i = 0; i < 100; ++i)
+      {
+        if (bulletVector[i].exists())
+          bullets.insert(&bulletVector[i]);
+      }
     }
     nukeDots.clear();
     for(int i = 0; i < data->nukeDotCount; ++i)
@@ -266,7 +349,10 @@ namespace BWAPI
         else
         {
           if (u->getPlayer() == this->self() && u->getType() == UnitTypes::Protoss_Pylon)
+          {
             pylons.insert(u);
+            powerGrid.addPylon(u);
+          }
         }
       }
       else if (data->events[e].type == EventType::UnitEvade)
@@ -285,7 +371,10 @@ namespace BWAPI
         else
         {
           if (u->getPlayer() == this->self() && u->getType() == UnitTypes::Protoss_Pylon)
+          {
             pylons.erase(u);
+            powerGrid.removePylon(u);
+          }
         }
       }
       else if (data->events[e].type==EventType::UnitRenegade)
@@ -310,20 +399,30 @@ namespace BWAPI
         }
       }
     }
-    foreach(UnitImpl* u, accessibleUnits)
+    if ( useFrameDelta )
     {
-      u->connectedUnits.clear();
-      u->loadedUnits.clear();
+      // Only relink the units that the server rewrote this frame
+      for ( int i = 0; i < data->changedUnitCount; ++i )
+      {
+        UnitImpl *u = &unitVector[data->changedUnits[i]];
+        unlinkUnit(u);
+        if ( u->exists() )
+          linkUnit(u);
+      }
     }
-    foreach(Unit u, accessibleUnits)
+    else
     {
-      if ( u->getType() == UnitTypes::Zerg_Larva && u->getHatchery() )
-        static_cast<UnitImpl*>(u->getHatchery())->connectedUnits.insert(u);
-      if ( u->getType() == UnitTypes::Protoss_Interceptor && u->getCarrier() )
-        static_cast<UnitImpl*>(u->getCarrier())->connectedUnits.insert(u);
-      if ( u->getTransport() )
-        static_cast<UnitImpl*>(u->getTransport())->loadedUnits.insert(u);
+      foreach(UnitImpl* u, accessibleUnits)
+      {
+        u->connectedUnits.clear();
+        u->loadedUnits.clear();
+      }
+      foreach(UnitImpl* u, accessibleUnits)
+        linkUnit(u);
     }
+    unitGrid.rebuild(accessibleUnits, data->mapWidth*32, data->mapHeight*32);
+    placementMap.invalidate(data->tileChanges);
+    powerGrid.update();
     selectedUnits.clear();
     for ( int i = 0; i < data->selectedUnitCount; ++i )
     {
@@ -331,31 +430,99 @@ namespace BWAPI
       if ( u )
         selectedUnits.insert(u);
     }
-    // clear player sets
-    _allies.clear();
-    _enemies.clear();
-    _observers.clear();
-    if ( thePlayer )
+    hasFrameBaseline = true;
+
+    // player sets only need to be rebuilt if a player changed
+    if ( !useFrameDelta || data->changedPlayerCount > 0 )
     {
-      // iterate each player
-      foreach(Player p, playerSet)
+      // clear player sets
+      _allies.clear();
+      _enemies.clear();
+      _observers.clear();
+      if ( thePlayer )
       {
-        // check if player should be skipped
-        if ( p->leftGame() || p->isDefeated() || p == thePlayer )
-          continue;
-        // add player to allies set
-        if ( thePlayer->isAlly(p) )
-          _allies.insert(p);
-        // add player to enemy set
-        if ( thePlayer->isEnemy(p) )
-          _enemies.insert(p);
-        // add player to obs set
-        if ( p->isObserver() )
-          _observers.insert(p);
+        // iterate each player
+        foreach(Player p, playerSet)
+        {
+          // check if player should be skipped
+          if ( p->leftGame() || p->isDefeated() || p == thePlayer )
+            continue;
+          // add player to allies set
+          if ( thePlayer->isAlly(p) )
+            _allies.insert(p);
+          // add player to enemy set
+          if ( thePlayer->isEnemy(p) )
+            _enemies.insert(p);
+          // add player to obs set
+          if ( p->isObserver() )
+            _observers.insert(p);
+        }
       }
     }
     this->processInterfaceEvents(); // Note sure if this should go here?
   }
+  //------------------------------------------------- RESYNC UNITS -------------------------------------------
+  void GameImpl::resyncUnits()
+  {
+    // Rebuilds the unit sets from the unit data, for observers that missed the discover/evade events of
+    // the frames they skipped
+    accessibleUnits.clear();
+    neutralUnits.clear();
+    minerals.clear();
+    geysers.clear();
+    pylons.clear();
+    powerGrid.clear();
+    for ( size_t i = 0; i < playerVector.size(); ++i )
+      playerVector[i].units.clear();
+
+    for ( size_t i = 0; i < unitVector.size(); ++i )
+    {
+      UnitImpl *u = &unitVector[i];
+      if ( !u->exists() )
+        continue;
+      accessibleUnits.insert(u);
+      static_cast<PlayerImpl*>(u->getPlayer())->units.insert(u);
+      if ( u->getPlayer()->isNeutral() )
+      {
+        neutralUnits.insert(u);
+        if ( u->getType().isMineralField() )
+          minerals.insert(u);
+        else if ( u->getType() == UnitTypes::Resource_Vespene_Geyser )
+          geysers.insert(u);
+      }
+      else if ( u->getPlayer() == this->self() && u->getType() == UnitTypes::Protoss_Pylon )
+      {
+        pylons.insert(u);
+        powerGrid.addPylon(u);
+      }
+    }
+    hasFrameBaseline = false;
+  }
+  //------------------------------------------------- LINK UNIT ----------------------------------------------
+  void GameImpl::linkUnit(UnitImpl *u)
+  {
+    u->connectedTo = nullptr;
+    if ( u->getType() == UnitTypes::Zerg_Larva && u->getHatchery() )
+      u->connectedTo = u->getHatchery();
+    if ( u->getType() == UnitTypes::Protoss_Interceptor && u->getCarrier() )
+      u->connectedTo = u->getCarrier();
+    u->loadedInto = u->getTransport();
+
+    if ( u->connectedTo )
+      static_cast<UnitImpl*>(u->connectedTo)->connectedUnits.insert(u);
+    if ( u->loadedInto )
+      static_cast<UnitImpl*>(u->loadedInto)->loadedUnits.insert(u);
+  }
+  //------------------------------------------------- UNLINK UNIT --------------------------------------------
+  void GameImpl::unlinkUnit(UnitImpl *u)
+  {
+    if ( u->connectedTo )
+      static_cast<UnitImpl*>(u->connectedTo)->connectedUnits.erase(u);
+    if ( u->loadedInto )
+      static_cast<UnitImpl*>(u->loadedInto)->loadedUnits.erase(u);
+    u->connectedTo = nullptr;
+    u->loadedInto  = nullptr;
+  }
   //----------------------------------------------- GET FORCE ------------------------------------------------
   Force GameImpl::getForce(int forceId) const
   {
@@ -365,7 +532,7 @@ namespace BWAPI
   }
   Region GameImpl::getRegion(int regionID) const
   {
-    if ( regionID < 0 || regionID >= data->regionCount )
+    if ( regionID < 0 || regionID >= staticData->regionCount )
       return nullptr;
     return regionArray[regionID];
   }
@@ -469,21 +636,48 @@ namespace BWAPI
     if ( data->flags[flag] == false )
       addCommand(BWAPIC::Command(BWAPIC::CommandType::EnableFlag,flag));
   }
+  //----------------------------------------------- ITERATE UNITS IN RECTANGLE -------------------------------
+  // Uses the unit grid once it has been built for the current frame, and the server's unit finder otherwise
+  template <typename F>
+  static void iterateUnitsInRectangle(const UnitGrid &grid, GameData *data, int left, int top, int right, int bottom, const F &callback)
+  {
+    if ( grid.isValid() )
+      grid.iterateRectangle(left, top, right, bottom, callback);
+    else
+      Templates::iterateUnitFinder<unitFinder>(data->xUnitSearch,
+                                               data->yUnitSearch,
+                                               data->unitSearchSize,
+                                               left,
+                                               top,
+                                               right,
+                                               bottom,
+                                               callback);
+  }
+  //----------------------------------------------- VISIT UNITS IN RECTANGLE ---------------------------------
+  void GameImpl::visitUnitsInRectangle(int left, int top, int right, int bottom, UnitVisitor visit, const void *context) const
+  {
+    iterateUnitsInRectangle(unitGrid,
+                            data,
+                            left,
+                            top,
+                            right,
+                            bottom,
+                            [&](Unit u){ visit(context, u); });
+  }
   //----------------------------------------------- GET UNITS IN RECTANGLE -----------------------------------
   Unitset GameImpl::getUnitsInRectangle(int left, int top, int right, int bottom, const UnitFilter &pred) const
   {
     Unitset unitFinderResults;
 
     // Have the unit finder do its stuff
-    Templates::iterateUnitFinder<unitFinder>(data->xUnitSearch,
-                                             data->yUnitSearch,
-                                             data->unitSearchSize,
-                                             left,
-                                             top,
-                                             right,
-                                             bottom,
-                                             [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                             unitFinderResults.push_back(u); });
+    iterateUnitsInRectangle(unitGrid,
+                            data,
+                            left,
+                            top,
+                            right,
+                            bottom,
+                            [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                            unitFinderResults.push_back(u); });
     // Return results
     return unitFinderResults;
   }
@@ -492,22 +686,21 @@ namespace BWAPI
     int bestDistance = 99999999;
     Unit pBestUnit = nullptr;
 
-    Templates::iterateUnitFinder<unitFinder>(data->xUnitSearch,
-                                             data->yUnitSearch,
-                                             data->unitSearchSize,
-                                             left,
-                                             top,
-                                             right,
-                                             bottom,
-                                             [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                           {
-                                                              int newDistance = u->getDistance(center);
-                                                              if ( newDistance < bestDistance )
-                                                              {
-                                                                pBestUnit = u;
-                                                                bestDistance = newDistance;
-                                                              }
-                                                           } } );
+    iterateUnitsInRectangle(unitGrid,
+                            data,
+                            left,
+                            top,
+                            right,
+                            bottom,
+                            [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                          {
+                                             int newDistance = u->getDistance(center);
+                                             if ( newDistance < bestDistance )
+                                             {
+                                               pBestUnit = u;
+                                               bestDistance = newDistance;
+                                             }
+                                          } } );
     return pBestUnit;
   }
   Unit GameImpl::getBestUnit(const BestUnitFilter &best, const UnitFilter &pred, Position center, int radius) const
@@ -521,20 +714,19 @@ namespace BWAPI
     topLeft.makeValid();
     botRight.makeValid();
 
-    Templates::iterateUnitFinder<unitFinder>(data->xUnitSearch,
-                                             data->yUnitSearch,
-                                             data->unitSearchSize,
-                                             topLeft.x,
-                                             topLeft.y,
-                                             botRight.x,
-                                             botRight.y,
-                                             [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                           {
-                                                             if ( pBestUnit == nullptr )
-                                                               pBestUnit = u;
-                                                             else
-                                                               pBestUnit = best(pBestUnit,u); 
-                                                           } } );
+    iterateUnitsInRectangle(unitGrid,
+                            data,
+                            topLeft.x,
+                            topLeft.y,
+                            botRight.x,
+                            botRight.y,
+                            [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                          {
+                                            if ( pBestUnit == nullptr )
+                                              pBestUnit = u;
+                                            else
+                                              pBestUnit = best(pBestUnit,u); 
+                                          } } );
 
     return pBestUnit;
   }
@@ -551,69 +743,109 @@ namespace BWAPI
   //---------------------------------------------- MAP FILE NAME ---------------------------------------------
   std::string GameImpl::mapFileName() const
   {
-    return std::string(data->mapFileName);
+    return std::string(staticData->mapFileName);
   }
   //---------------------------------------------- MAP PATH NAME ---------------------------------------------
   std::string GameImpl::mapPathName() const
   {
-    return std::string(data->mapPathName);
+    return std::string(staticData->mapPathName);
   }
   //------------------------------------------------ MAP NAME ------------------------------------------------
   std::string GameImpl::mapName() const
   {
-    return std::string(data->mapName);
+    return std::string(staticData->mapName);
   }
   //----------------------------------------------- GET MAP HASH ---------------------------------------------
   std::string GameImpl::mapHash() const
   {
-    return std::string(data->mapHash);
+    return std::string(staticData->mapHash);
   }
   //--------------------------------------------- IS WALKABLE ------------------------------------------------
   bool GameImpl::isWalkable(int x, int y) const
   {
     if ( !WalkPosition(x, y) )
       return 0;
-    return data->isWalkable[x][y];
+    return staticData->isWalkable.get(x, y);
   }
   //--------------------------------------------- GET GROUND HEIGHT ------------------------------------------
   int GameImpl::getGroundHeight(int x, int y) const
   {
     if ( !TilePosition(x, y) )
       return 0;
-    return data->getGroundHeight[x][y];
+    return staticData->getGroundHeight[x][y];
   }
   //--------------------------------------------- IS BUILDABLE -----------------------------------------------
   bool GameImpl::isBuildable(int x, int y, bool includeBuildings) const
   {
     if ( !TilePosition(x, y) )
       return 0;
-    return data->isBuildable[x][y] && ( includeBuildings ? !data->isOccupied[x][y] : true );
+    return staticData->isBuildable.get(x, y) && ( includeBuildings ? !data->isOccupied.get(x, y) : true );
   }
   //--------------------------------------------- IS VISIBLE -------------------------------------------------
   bool GameImpl::isVisible(int x, int y) const
   {
     if ( !TilePosition(x, y) )
       return 0;
-    return data->isVisible[x][y];
+    return data->isVisible.get(x, y);
   }
   //--------------------------------------------- IS EXPLORED ------------------------------------------------
   bool GameImpl::isExplored(int x, int y) const
   {
     if ( !TilePosition(x, y) )
       return 0;
-    return data->isExplored[x][y];
+    return data->isExplored.get(x, y);
   }
   //--------------------------------------------- HAS CREEP --------------------------------------------------
   bool GameImpl::hasCreep(int x, int y) const
   {
     if ( !TilePosition(x, y) )
       return 0;
-    return data->hasCreep[x][y];
+    return data->hasCreep.get(x, y);
+  }
+  //--------------------------------------------- CLIP TILE RECT ---------------------------------------------
+  // Clips a tile rectangle to the map, returns false if nothing is left of it
+  static bool clipTileRect(const GameData *data, int &left, int &top, int &right, int &bottom)
+  {
+    if ( left < 0 )
+      left = 0;
+    if ( top < 0 )
+      top = 0;
+    if ( right >= data->mapWidth )
+      right = data->mapWidth - 1;
+    if ( bottom >= data->mapHeight )
+      bottom = data->mapHeight - 1;
+    return left <= right && top <= bottom;
+  }
+  //--------------------------------------------- IS ANY VISIBLE ---------------------------------------------
+  bool GameImpl::isAnyVisible(int left, int top, int right, int bottom) const
+  {
+    if ( !clipTileRect(data, left, top, right, bottom) )
+      return false;
+    return data->isVisible.anyInRect(left, top, right, bottom);
+  }
+  //--------------------------------------------- IS ALL EXPLORED --------------------------------------------
+  bool GameImpl::isAllExplored(int left, int top, int right, int bottom) const
+  {
+    if ( !clipTileRect(data, left, top, right, bottom) )
+      return false;
+    return data->isExplored.allInRect(left, top, right, bottom);
+  }
+  //--------------------------------------------- HAS ANY CREEP ----------------------------------------------
+  bool GameImpl::hasAnyCreep(int left, int top, int right, int bottom) const
+  {
+    if ( !clipTileRect(data, left, top, right, bottom) )
+      return false;
+    return data->hasCreep.anyInRect(left, top, right, bottom);
+  }
+  //-------------------------------------------- GET CHANGED TILES -------------------------------------------
+  bool GameImpl::getChangedTiles(std::vector<TilePosition> &tiles, int layers) const
+  {
+    return data->tileChanges.getTiles(layers, data->mapWidth, data->mapHeight, tiles);
   }
   //--------------------------------------------- HAS POWER --------------------------------------------------
   bool GameImpl::hasPowerPrecise(int x, int y, UnitType unitType) const
   {
-    return Templates::hasPower(x, y, unitType, pylons);
+    return Templates::hasPower(x, y, unitType, powerGrid);
   }
   //------------------------------------------------ PRINTF --------------------------------------------------
   void GameImpl::vPrintf(const char *format, va_list arg)
@@ -718,12 +950,35 @@ namespace BWAPI
   //------------------------------------------- ISSUE COMMAND ------------------------------------------------
   bool GameImpl::issueCommand(const Unitset& units, UnitCommand command)
   {
+    // Prepare the command for each unit, and send it once for all of them
+    std::vector<int> &unitIndices = commandGroupIndices;
+    unitIndices.clear();
+
     bool success = false;
-    //FIX FIX FIX naive implementation
     foreach(Unit u, units)
     {
-      success |= u->issueCommand(command);
+      UnitCommand c = command;
+      bool duplicate;
+      if ( !static_cast<UnitImpl*>(u)->prepareCommand(c, duplicate) )
+        continue;
+      success = true;
+      if ( !duplicate )
+        unitIndices.push_back(c.unit->getID());
     }
+    if ( unitIndices.empty() )
+      return success;
+
+    BWAPIC::UnitCommand c;
+    c.type        = command.type;
+    c.unitIndex   = unitIndices.front();
+    c.targetIndex = command.target ? command.target->getID() : -1;
+    c.x     = command.x;
+    c.y     = command.y;
+    c.extra = command.extra;
+    if ( unitIndices.size() == 1 )
+      addUnitCommand(c);
+    else
+      addUnitCommandGroup(c, unitIndices);
     return success;
   }
   //------------------------------------------ GET SELECTED UNITS --------------------------------------------
@@ -774,7 +1029,7 @@ namespace BWAPI
   //-------------------------------------------------- DRAW TEXT ---------------------------------------------
   void GameImpl::vDrawText(CoordinateType::Enum ctype, int x, int y, const char *format, va_list arg)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && recordingDrawList == -1 ) return;
     char buffer[512];
     VSNPrintf(buffer, format, arg);
     BWAPIC::Shape s(BWAPIC::ShapeType::Text,ctype,x,y,0,0,0,textSize,0,false);
@@ -783,39 +1038,79 @@ namespace BWAPI
   //--------------------------------------------------- DRAW BOX ---------------------------------------------
   void GameImpl::drawBox(CoordinateType::Enum ctype, int left, int top, int right, int bottom, Color color, bool isSolid)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && recordingDrawList == -1 ) return;
     addShape(BWAPIC::Shape(BWAPIC::ShapeType::Box,ctype,left,top,right,bottom,0,0,color,isSolid));
   }
   //------------------------------------------------ DRAW TRIANGLE -------------------------------------------
   void GameImpl::drawTriangle(CoordinateType::Enum ctype, int ax, int ay, int bx, int by, int cx, int cy, Color color, bool isSolid)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && recordingDrawList == -1 ) return;
     addShape(BWAPIC::Shape(BWAPIC::ShapeType::Triangle,ctype,ax,ay,bx,by,cx,cy,color,isSolid));
   }
   //------------------------------------------------- DRAW CIRCLE --------------------------------------------
   void GameImpl::drawCircle(CoordinateType::Enum ctype, int x, int y, int radius, Color color, bool isSolid)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && recordingDrawList == -1 ) return;
     addShape(BWAPIC::Shape(BWAPIC::ShapeType::Circle,ctype,x,y,0,0,radius,0,color,isSolid));
   }
   //------------------------------------------------- DRAW ELIPSE --------------------------------------------
   void GameImpl::drawEllipse(CoordinateType::Enum ctype, int x, int y, int xrad, int yrad, Color color, bool isSolid)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && recordingDrawList == -1 ) return;
     addShape(BWAPIC::Shape(BWAPIC::ShapeType::Ellipse,ctype,x,y,0,0,xrad,yrad,color,isSolid));
   }
 
   void GameImpl::drawDot(CoordinateType::Enum ctype, int x, int y, Color color)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && recordingDrawList == -1 ) return;
     addShape(BWAPIC::Shape(BWAPIC::ShapeType::Dot,ctype,x,y,0,0,0,0,color,false));
   }
   //-------------------------------------------------- DRAW LINE ---------------------------------------------
   void GameImpl::drawLine(CoordinateType::Enum ctype, int x1, int y1, int x2, int y2, Color color)
   {
-    if ( !data->hasGUI ) return;
+    if ( !data->hasGUI && recordingDrawList == -1 ) return;
     addShape(BWAPIC::Shape(BWAPIC::ShapeType::Line,ctype,x1,y1,x2,y2,0,0,color,false));
   }
+  //-------------------------------------------------- DRAW LISTS --------------------------------------------
+  int GameImpl::createDrawList(const char *name)
+  {
+    if ( readOnly )
+      return -1;
+    for ( size_t i = 0; i < drawListNames.size(); ++i )
+    {
+      if ( drawListNames[i] == name )
+        return (int)i;
+    }
+    // The server keeps the client's lists under the handles the client chooses
+    int list = (int)drawListNames.size();
+    if ( list >= GameData::MAX_DRAW_LISTS )
+      return -1;
+    drawListNames.push_back(name);
+    addCommand(BWAPIC::Command(BWAPIC::CommandType::CreateDrawList, list, addString(name)));
+    return list;
+  }
+  void GameImpl::beginDrawList(int list)
+  {
+    endDrawList();
+    if ( readOnly || list < 0 || list >= (int)drawListNames.size() )
+      return;
+    // The shapes are written to the frame as usual, the server moves them into the list
+    addCommand(BWAPIC::Command(BWAPIC::CommandType::BeginDrawList, list, data->shapeCount));
+    recordingDrawList = list;
+  }
+  void GameImpl::endDrawList()
+  {
+    if ( recordingDrawList == -1 )
+      return;
+    addCommand(BWAPIC::Command(BWAPIC::CommandType::EndDrawList, recordingDrawList, data->shapeCount));
+    recordingDrawList = -1;
+  }
+  void GameImpl::clearDrawList(int list)
+  {
+    if ( list < 0 || list >= (int)drawListNames.size() )
+      return;
+    addCommand(BWAPIC::Command(BWAPIC::CommandType::ClearDrawList, list));
+  }
   int GameImpl::getLatencyFrames() const
   {
     return data->latencyFrames;
@@ -846,6 +1141,8 @@ namespace BWAPI
   }
   void GameImpl::setLatCom(bool isEnabled)
   {
+    if ( readOnly )
+      return;
     int e=0;
     if (isEnabled) e=1;
     //update shared memory
@@ -859,6 +1156,8 @@ namespace BWAPI
   }
   void GameImpl::setGUI(bool enabled)
   {
+    if ( readOnly )
+      return;
     int e=0;
     if (enabled) e=1;
     data->hasGUI = enabled;
@@ -880,8 +1179,14 @@ namespace BWAPI
     if ( !mapFileName || strlen(mapFileName) >= MAX_PATH || !mapFileName[0] )
       return setLastError(Errors::Invalid_Parameter);
 
+#ifdef _WIN32
     if ( GetFileAttributes(mapFileName) == INVALID_FILE_ATTRIBUTES )
       return setLastError(Errors::File_Not_Found);
+#else
+    struct stat fileInfo;
+    if ( stat(mapFileName, &fileInfo) != 0 )
+      return setLastError(Errors::File_Not_Found);
+#endif
 
     addCommand( BWAPIC::Command(BWAPIC::CommandType::SetMap, addString(mapFileName)) );
     return setLastError();
@@ -892,50 +1197,12 @@ namespace BWAPI
     if ( !source.isValid() || !destination.isValid() )
       return this->setLastError(Errors::Unreachable_Location);
 
-    if ( data )
+    int srcRegion = _getRegionIdAt(source.x, source.y);
+    int dstRegion = _getRegionIdAt(destination.x, destination.y);
+    if ( srcRegion != -1 && dstRegion != -1 )
     {
-      unsigned short srcIdx = data->mapTileRegionId[source.x/32][source.y/32];
-      unsigned short dstIdx = data->mapTileRegionId[destination.x/32][destination.y/32];
-
-      unsigned short srcGroup = 0;
-      unsigned short dstGroup = 0;
-      if ( srcIdx & 0x2000 )
-      {
-        int minitilePosX = (source.x&0x1F)/8;
-        int minitilePosY = (source.y&0x1F)/8;
-        int minitileShift = minitilePosX + minitilePosY * 4;
-        unsigned short miniTileMask = data->mapSplitTilesMiniTileMask[srcIdx&0x1FFF];
-        unsigned short rgn1         = data->mapSplitTilesRegion1[srcIdx&0x1FFF];
-        unsigned short rgn2         = data->mapSplitTilesRegion2[srcIdx&0x1FFF];
-        if ( (miniTileMask >> minitileShift) & 1 )
-          srcGroup = data->regions[rgn2].islandID;
-        else
-          srcGroup = data->regions[rgn1].islandID;
-      }
-      else
-      {
-        srcGroup = data->regions[srcIdx].islandID;
-      }
-
-      if ( dstIdx & 0x2000 )
-      {
-        int minitilePosX = (destination.x&0x1F)/8;
-        int minitilePosY = (destination.y&0x1F)/8;
-        int minitileShift = minitilePosX + minitilePosY * 4;
-
-        unsigned short miniTileMask = data->mapSplitTilesMiniTileMask[dstIdx&0x1FFF];
-        unsigned short rgn1         = data->mapSplitTilesRegion1[dstIdx&0x1FFF];
-        unsigned short rgn2         = data->mapSplitTilesRegion2[dstIdx&0x1FFF];
-
-        if ( (miniTileMask >> minitileShift) & 1 )
-          dstGroup = data->regions[rgn2].islandID;
-        else
-          dstGroup = data->regions[rgn1].islandID;
-      }
-      else
-      {
-        dstGroup = data->regions[dstIdx].islandID;
-      }
+      unsigned short srcGroup = staticData->regions[srcRegion].islandID;
+      unsigned short dstGroup = staticData->regions[dstRegion].islandID;
 
       if ( srcGroup == dstGroup )
         return true;
@@ -963,21 +1230,40 @@ namespace BWAPI
       this->setLastError(BWAPI::Errors::Invalid_Parameter);
       return nullptr;
     }
-    unsigned short idx = data->mapTileRegionId[x/32][y/32];
-    if ( idx & 0x2000 )
+    return this->getRegion(_getRegionIdAt(x, y));
+  }
+  //--------------------------------------------- GET REGION ID AT -------------------------------------------
+  int GameImpl::_getRegionIdAt(int x, int y) const
+  {
+    // The position must be valid. The table only exists between onMatchStart and onMatchEnd, while
+    // data->mapWidth may describe a map before and after, so gives -1 outside of it.
+    size_t index = (y/8)*(data->mapWidth*4) + x/8;
+    if ( index >= walkTileRegions.size() )
+      return -1;
+    return walkTileRegions[index];
+  }
+  //------------------------------------------ COMPUTE WALK TILE REGIONS -------------------------------------
+  void GameImpl::_computeWalkTileRegions()
+  {
+    int walkWidth = data->mapWidth*4, walkHeight = data->mapHeight*4;
+    walkTileRegions.resize(walkWidth*walkHeight);
+    for ( int y = 0; y < walkHeight; ++y )
     {
-      int minitilePosX = (x&0x1F)/8;
-      int minitilePosY = (y&0x1F)/8;
-      int minitileShift = minitilePosX + minitilePosY * 4;
-      unsigned short miniTileMask = data->mapSplitTilesMiniTileMask[idx&0x1FFF];
-      unsigned short rgn1         = data->mapSplitTilesRegion1[idx&0x1FFF];
-      unsigned short rgn2         = data->mapSplitTilesRegion2[idx&0x1FFF];
-      if ( (miniTileMask >> minitileShift) & 1 )
-        return this->getRegion(rgn2);
-      else
-        return this->getRegion(rgn1);
+      for ( int x = 0; x < walkWidth; ++x )
+      {
+        unsigned short idx = staticData->mapTileRegionId[x/4][y/4];
+        if ( idx & 0x2000 )
+        {
+          // Split tiles hold two regions, the mask selects the second region for each mini-tile
+          int minitileShift = (x&3) + (y&3) * 4;
+          if ( (staticData->mapSplitTilesMiniTileMask[idx&0x1FFF] >> minitileShift) & 1 )
+            idx = staticData->mapSplitTilesRegion2[idx&0x1FFF];
+          else
+            idx = staticData->mapSplitTilesRegion1[idx&0x1FFF];
+        }
+        walkTileRegions[y*walkWidth + x] = idx;
+      }
     }
-    return this->getRegion(idx);
   }
   int GameImpl::getLastEventTime() const
   {
@@ -4,17 +4,21 @@
 namespace BWAPI
 {
   RegionImpl::RegionImpl(int index)
-    : self ( &BWAPI::BWAPIClient.data->regions[index] )
+    : self ( &BWAPI::BWAPIClient.staticData->regions[index] )
     , closestAccessibleRgn(nullptr)
     , closestInaccessibleRgn(nullptr)
   { }
   void RegionImpl::setNeighbors()
   {
+    const StaticGameData *staticData = BWAPI::BWAPIClient.staticData;
+    int firstNeighbor = staticData->regionNeighborOffsets[self->id];
+    int lastNeighbor  = staticData->regionNeighborOffsets[self->id + 1];
+
     int accessibleBestDist    = 99999;
     int inaccessibleBestDist  = 99999;
-    for ( int i = 0; i < self->neighborCount; ++i )
+    for ( int i = firstNeighbor; i < lastNeighbor; ++i )
     {
-      BWAPI::Region neighbor = Broodwar->getRegion(self->neighbors[i]);
+      BWAPI::Region neighbor = Broodwar->getRegion(staticData->regionNeighbors[i]);
       this->neighbors.insert(neighbor);
 
       // Obtain the closest accessible and inaccessible Regions from their Region center
@@ -16,11 +16,30 @@ namespace BWAPI
   {
     this->self = &(BWAPI::BWAPIClient.data->units[id]);
     this->id   = id;
+    this->connectedTo = nullptr;
+    this->loadedInto  = nullptr;
     clear();
   }
-  //--------------------------------------------- ISSUE COMMAND ----------------------------------------------
-  bool UnitImpl::issueCommand(UnitCommand command)
+  //------------------------------------------- IS REPEATABLE COMMAND ----------------------------------------
+  // Commands that have an effect every time they are given, so that giving them again in the same
+  // frame is not redundant
+  static bool isRepeatableCommand(const UnitCommand &command)
   {
+    return command.isQueued() ||
+           command.type == UnitCommandTypes::Train       ||
+           command.type == UnitCommandTypes::Cancel_Train ||
+           command.type == UnitCommandTypes::Cancel_Train_Slot ||
+           command.type == UnitCommandTypes::Use_Tech;
+  }
+  //-------------------------------------------- PREPARE COMMAND ---------------------------------------------
+  bool UnitImpl::prepareCommand(UnitCommand &command, bool &duplicate)
+  {
+    duplicate = false;
+
+    // Read-only observers can't command units
+    if ( static_cast<GameImpl*>(BroodwarPtr)->readOnly )
+      return Broodwar->setLastError(Errors::Access_Denied);
+
     if ( !canIssueCommand(command) )
       return false;
 
@@ -45,20 +64,40 @@ namespace BWAPI
         return false;
     }
 
-    BWAPIC::UnitCommand c;
-    c.type      = command.type;
-    c.unitIndex = command.unit->getID();
-    if ( command.target )
-      c.targetIndex = command.target->getID();
-    else
-      c.targetIndex = -1;
-    c.x     = command.x;
-    c.y     = command.y;
-    c.extra = command.extra;
+    // Bots often give the same command again, there is no need to send it twice in one frame
+    if ( lastCommandFrame == Broodwar->getFrameCount() && lastCommand == command &&
+         lastCommand.unit == command.unit && !isRepeatableCommand(command) )
+    {
+      duplicate = true;
+      return true;
+    }
+
     Command(command).execute(0);
-    static_cast<GameImpl*>(BroodwarPtr)->addUnitCommand(c);
     lastCommandFrame = Broodwar->getFrameCount();
     lastCommand      = command;
     return true;
   }
+  //--------------------------------------------- ISSUE COMMAND ----------------------------------------------
+  bool UnitImpl::issueCommand(UnitCommand command)
+  {
+    bool duplicate;
+    if ( !prepareCommand(command, duplicate) )
+      return false;
+
+    if ( !duplicate )
+    {
+      BWAPIC::UnitCommand c;
+      c.type      = command.type;
+      c.unitIndex = command.unit->getID();
+      if ( command.target )
+        c.targetIndex = command.target->getID();
+      else
+        c.targetIndex = -1;
+      c.x     = command.x;
+      c.y     = command.y;
+      c.extra = command.extra;
+      static_cast<GameImpl*>(BroodwarPtr)->addUnitCommand(c);
+    }
+    return true;
+  }
 }
@@ -0,0 +1,120 @@
+#include <BWAPI/FrameArena.h>
+#include <BWAPI/Game.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace BWAPI
+{
+  namespace FrameArena
+  {
+    // Size of the regular blocks, larger requests get a block of their own
+    static const size_t BLOCK_SIZE = 64*1024;
+    static const size_t ALIGNMENT  = 16;
+
+    static std::vector<char*> blocks;       // blocks that are kept between frames
+    static std::vector<char*> largeBlocks;  // blocks that are freed on reset
+    static size_t currentBlock = 0;
+    static size_t blockOffset  = 0;
+    static size_t largeCapacity = 0;
+    static int    lastFrame    = -1;
+
+    static int    arenaAllocations = 0;
+    static size_t arenaBytes       = 0;
+    static int    heapAllocations  = 0;
+
+    void *allocate(size_t size)
+    {
+      // Memory from a previous frame is no longer in use
+      if ( BroodwarPtr && BroodwarPtr->getFrameCount() != lastFrame )
+      {
+        reset();
+        lastFrame = BroodwarPtr->getFrameCount();
+      }
+
+      size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+      if ( size == 0 )
+        size = ALIGNMENT;
+
+      char *mem = nullptr;
+      if ( size > BLOCK_SIZE/4 )
+      {
+        mem = (char*)malloc(size);
+        if ( !mem )
+          return nullptr;
+        largeBlocks.push_back(mem);
+        largeCapacity += size;
+      }
+      else
+      {
+        // Move on to the next block if the current one is full
+        if ( currentBlock < blocks.size() && blockOffset + size > BLOCK_SIZE )
+        {
+          ++currentBlock;
+          blockOffset = 0;
+        }
+        if ( currentBlock == blocks.size() )
+        {
+          char *block = (char*)malloc(BLOCK_SIZE);
+          if ( !block )
+            return nullptr;
+          blocks.push_back(block);
+          blockOffset = 0;
+        }
+        mem = blocks[currentBlock] + blockOffset;
+        blockOffset += size;
+      }
+
+      ++arenaAllocations;
+      arenaBytes += size;
+      return mem;
+    }
+    void *reallocate(void *ptr, size_t oldSize, size_t newSize)
+    {
+      if ( newSize <= oldSize && ptr )
+        return ptr;
+
+      void *mem = allocate(newSize);
+      if ( mem && ptr && oldSize )
+        memcpy(mem, ptr, oldSize);
+      return mem;
+    }
+    void reset()
+    {
+      for ( auto it = largeBlocks.begin(); it != largeBlocks.end(); ++it )
+        free(*it);
+      largeBlocks.clear();
+      largeCapacity = 0;
+
+      currentBlock = 0;
+      blockOffset  = 0;
+    }
+    int getArenaAllocations()
+    {
+      return arenaAllocations;
+    }
+    size_t getArenaBytes()
+    {
+      return arenaBytes;
+    }
+    int getHeapAllocations()
+    {
+      return heapAllocations;
+    }
+    size_t getCapacity()
+    {
+      return blocks.size()*BLOCK_SIZE + largeCapacity;
+    }
+    void resetCounters()
+    {
+      arenaAllocations = 0;
+      arenaBytes       = 0;
+      heapAllocations  = 0;
+    }
+    void countHeapAllocation()
+    {
+      ++heapAllocations;
+    }
+  }
+}
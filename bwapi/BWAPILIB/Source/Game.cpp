@@ -14,6 +14,8 @@
 #include <BWAPI/WeaponType.h>
 
 #include <cstdarg>
+#include <climits>
+#include <algorithm>
 
 namespace BWAPI
 {
@@ -659,6 +661,10 @@ namespace BWAPI
   {
     return this->isWalkable(position.x, position.y);
   }
+  int Game::getClearance(BWAPI::WalkPosition position) const
+  {
+    return this->getClearance(position.x, position.y);
+  }
   int Game::getGroundHeight(TilePosition position) const
   {
     return this->getGroundHeight(position.x, position.y);
@@ -679,6 +685,32 @@ namespace BWAPI
   {
     return this->hasCreep(position.x, position.y);
   }
+  int Game::getGroundDistance(Position source, Position destination) const
+  {
+    Region sourceRegion      = this->getRegionAt(source);
+    Region destinationRegion = this->getRegionAt(destination);
+    if ( !sourceRegion || !destinationRegion )
+      return -1;
+    if ( sourceRegion == destinationRegion )
+      return source.getApproxDistance(destination);
+
+    int between = this->getGroundDistance(sourceRegion, destinationRegion);
+    if ( between < 0 )
+      return -1;
+    return source.getApproxDistance(sourceRegion->getCenter()) + between + destinationRegion->getCenter().getApproxDistance(destination);
+  }
+  bool Game::isAnyVisible(TilePosition topLeft, TilePosition bottomRight) const
+  {
+    return this->isAnyVisible(topLeft.x, topLeft.y, bottomRight.x, bottomRight.y);
+  }
+  bool Game::isAllExplored(TilePosition topLeft, TilePosition bottomRight) const
+  {
+    return this->isAllExplored(topLeft.x, topLeft.y, bottomRight.x, bottomRight.y);
+  }
+  bool Game::hasAnyCreep(TilePosition topLeft, TilePosition bottomRight) const
+  {
+    return this->hasAnyCreep(topLeft.x, topLeft.y, bottomRight.x, bottomRight.y);
+  }
   Unitset Game::getUnitsOnTile(int tileX, int tileY, const UnitFilter &pred) const
   {
     return this->getUnitsOnTile(TilePosition(tileX,tileY), pred);
@@ -693,16 +725,27 @@ namespace BWAPI
   }
   Unitset Game::getUnitsInRadius(int x, int y, int radius, const UnitFilter &pred) const
   {
-    return this->getUnitsInRectangle(x - radius,
-                                     y - radius,
-                                     x + radius,
-                                     y + radius,
+    // getDistance counts the position as 3 pixels wide, so a unit whose edge is one pixel outside
+    // of center +/- radius is still within radius. The rectangles below are padded to include it.
+    return this->getUnitsInRectangle(x - radius - 1,
+                                     y - radius - 1,
+                                     x + radius + 1,
+                                     y + radius + 1,
                                      [&x,&y,&radius,&pred](Unit u){ return u->getDistance(Position(x,y)) <= radius && (!pred.isValid() || pred(u)); });
   }
   Unitset Game::getUnitsInRadius(Position center, int radius, const UnitFilter &pred) const
   {
     return this->getUnitsInRadius(center.x, center.y, radius, pred);
   }
+  void Game::visitUnitsInRadius(Position center, int radius, UnitVisitor visit, const void *context) const
+  {
+    this->forEachUnitInRectangle(center.x - radius - 1,
+                                 center.y - radius - 1,
+                                 center.x + radius + 1,
+                                 center.y + radius + 1,
+                                 [&](Unit u){ if ( u->getDistance(center) <= radius )
+                                                visit(context, u); });
+  }
   Unitset Game::getUnitsInRectangle(BWAPI::Position topLeft, BWAPI::Position bottomRight, const UnitFilter &pred) const
   {
     return this->getUnitsInRectangle(topLeft.x, topLeft.y, bottomRight.x, bottomRight.y, pred);
@@ -711,10 +754,191 @@ namespace BWAPI
   {
     return this->getClosestUnitInRectangle(center,
                                             [&](Unit u){ return u->getDistance(center) <= radius && (!pred.isValid() || pred(u));},
-                                            center.x - radius,
-                                            center.y - radius,
-                                            center.x + radius,
-                                            center.y + radius);
+                                            center.x - radius - 1,
+                                            center.y - radius - 1,
+                                            center.x + radius + 1,
+                                            center.y + radius + 1);
+  }
+  //------------------------------------------ CLOSEST UNITS ----------------------------------------
+  typedef std::pair<int, Unit> UnitDistance;
+
+  static bool isCloser(const UnitDistance &a, const UnitDistance &b)
+  {
+    return a.first < b.first;
+  }
+  // Keeps the k closest units seen so far, as a heap with the farthest one on top
+  static void addClosestUnit(std::vector<UnitDistance> &closest, size_t k, int distance, Unit u)
+  {
+    if ( closest.size() < k )
+    {
+      closest.push_back(UnitDistance(distance, u));
+      std::push_heap(closest.begin(), closest.end(), isCloser);
+    }
+    else if ( distance < closest.front().first )
+    {
+      std::pop_heap(closest.begin(), closest.end(), isCloser);
+      closest.back() = UnitDistance(distance, u);
+      std::push_heap(closest.begin(), closest.end(), isCloser);
+    }
+  }
+  static Unitset sortClosestUnits(std::vector<UnitDistance> &closest)
+  {
+    std::sort_heap(closest.begin(), closest.end(), isCloser);
+    Unitset result(closest.size());
+    for ( auto it = closest.begin(); it != closest.end(); ++it )
+      result.push_back(it->second);
+    return result;
+  }
+  // Buckets the candidates of a batched closest units query by position, so that each source
+  // only measures the distance to the candidates in the cells around it.
+  class ClosestUnitGrid
+  {
+  public:
+    static const int CELL_SIZE = 128;
+
+    explicit ClosestUnitGrid(const std::vector<Unit> &units)
+      : originX(INT_MAX), originY(INT_MAX), columns(0), rows(0), maxExtent(0)
+    {
+      if ( units.empty() )
+        return;
+
+      int maxX = INT_MIN, maxY = INT_MIN;
+      for ( auto u = units.begin(); u != units.end(); ++u )
+      {
+        Position p = (*u)->getPosition();
+        originX = std::min(originX, p.x);
+        originY = std::min(originY, p.y);
+        maxX    = std::max(maxX, p.x);
+        maxY    = std::max(maxY, p.y);
+        maxExtent = std::max(maxExtent, extentOf(*u));
+      }
+      columns = (maxX - originX) / CELL_SIZE + 1;
+      rows    = (maxY - originY) / CELL_SIZE + 1;
+
+      // Counting sort of the units into their cells
+      cellStart.assign(columns*rows + 1, 0);
+      for ( auto u = units.begin(); u != units.end(); ++u )
+        ++cellStart[cellOf((*u)->getPosition()) + 1];
+      for ( size_t i = 1; i < cellStart.size(); ++i )
+        cellStart[i] += cellStart[i - 1];
+
+      cellUnits.resize(units.size());
+      std::vector<int> next(cellStart.begin(), cellStart.end() - 1);
+      for ( auto u = units.begin(); u != units.end(); ++u )
+        cellUnits[next[cellOf((*u)->getPosition())]++] = *u;
+    }
+
+    // Searches rings of cells outward from the source until no unit in the next ring can be
+    // closer than the farthest of the k closest units found so far, or than radius.
+    void findClosest(Unit source, int k, int radius, std::vector<UnitDistance> &closest) const
+    {
+      int cell = cellOf(source->getPosition());
+      int sx = cell % columns, sy = cell / columns;
+      int lastRing = std::max(std::max(sx, columns - 1 - sx), std::max(sy, rows - 1 - sy));
+
+      // The approximate distance is never shorter than the gap along either axis. A unit in
+      // ring r is at least (r-1) cells away from the source along one axis, less the extents.
+      int slack = extentOf(source) + maxExtent + 1;
+      for ( int r = 0; r <= lastRing; ++r )
+      {
+        int bound = (r - 1)*CELL_SIZE - slack;
+        if ( bound > radius || (closest.size() == static_cast<size_t>(k) && bound >= closest.front().first) )
+          break;
+
+        for ( int y = sy - r; y <= sy + r; ++y )
+        {
+          if ( y < 0 || y >= rows )
+            continue;
+          // Only the edges of the ring, unless this is the top or bottom row
+          int step = (y == sy - r || y == sy + r) ? 1 : 2*r;
+          for ( int x = sx - r; x <= sx + r; x += step )
+          {
+            if ( x < 0 || x >= columns )
+              continue;
+            for ( int i = cellStart[y*columns + x]; i < cellStart[y*columns + x + 1]; ++i )
+            {
+              Unit u = cellUnits[i];
+              if ( u == source )
+                continue;
+              int distance = source->getDistance(u);
+              if ( distance <= radius )
+                addClosestUnit(closest, k, distance, u);
+            }
+          }
+        }
+      }
+    }
+  private:
+    // The farthest that the bounds of a unit extend from its position
+    static int extentOf(Unit u)
+    {
+      Position p = u->getPosition();
+      return std::max(std::max(p.x - u->getLeft(), u->getRight() - p.x),
+                      std::max(p.y - u->getTop(), u->getBottom() - p.y));
+    }
+    // Positions outside of the grid belong to the nearest cell
+    int cellOf(Position p) const
+    {
+      int x = (p.x - originX) / CELL_SIZE;
+      int y = (p.y - originY) / CELL_SIZE;
+      x = x < 0 ? 0 : (x >= columns ? columns - 1 : x);
+      y = y < 0 ? 0 : (y >= rows ? rows - 1 : y);
+      return y*columns + x;
+    }
+
+    int originX, originY;
+    int columns, rows;
+    int maxExtent;
+    std::vector<int> cellStart;
+    std::vector<Unit> cellUnits;
+  };
+
+  Unitset Game::getClosestUnits(Position center, int k, const UnitFilter &pred, int radius) const
+  {
+    if ( k <= 0 )
+      return Unitset::none;
+
+    std::vector<UnitDistance> closest;
+    this->forEachUnitInRadius(center, radius, [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                                             addClosestUnit(closest, k, u->getDistance(center), u); });
+    return sortClosestUnits(closest);
+  }
+  std::vector<Unitset> Game::getClosestUnits(const Unitset &sources, int k, const UnitFilter &pred, int radius) const
+  {
+    std::vector<Unitset> results;
+    results.reserve(sources.size());
+
+    // Get the bounds that cover all of the sources
+    int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+    for ( auto s = sources.begin(); s != sources.end(); ++s )
+    {
+      if ( !(*s)->exists() )
+        continue;
+      left   = std::min(left,   (*s)->getLeft());
+      top    = std::min(top,    (*s)->getTop());
+      right  = std::max(right,  (*s)->getRight());
+      bottom = std::max(bottom, (*s)->getBottom());
+    }
+
+    // Collect the candidates in one pass, so pred is only called once per unit
+    std::vector<Unit> candidates;
+    if ( k > 0 && left <= right )
+    {
+      this->forEachUnitInRectangle(left - radius - 1, top - radius - 1, right + radius + 1, bottom + radius + 1,
+                                   [&](Unit u){ if ( !pred.isValid() || pred(u) )
+                                                  candidates.push_back(u); });
+    }
+
+    ClosestUnitGrid grid(candidates);
+    std::vector<UnitDistance> closest;
+    for ( auto s = sources.begin(); s != sources.end(); ++s )
+    {
+      closest.clear();
+      if ( (*s)->exists() && !candidates.empty() )
+        grid.findClosest(*s, k, radius, closest);
+      results.push_back(sortClosestUnits(closest));
+    }
+    return results;
   }
   //------------------------------------------ REGIONS -----------------------------------------------
   BWAPI::Region Game::getRegionAt(BWAPI::Position position) const
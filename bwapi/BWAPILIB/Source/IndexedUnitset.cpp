@@ -0,0 +1,134 @@
+#include <BWAPI/IndexedUnitset.h>
+#include <BWAPI/Unit.h>
+
+namespace BWAPI
+{
+  IndexedUnitset::IndexedUnitset(size_t initialSize) : units(initialSize) { };
+
+  int IndexedUnitset::slotOf(int id) const
+  {
+    if ( id < 0 || id >= (int)slots.size() )
+      return 0;
+    return slots[id];
+  }
+  bool IndexedUnitset::contains(Unit u) const
+  {
+    if ( !u )
+      return false;
+    int id = u->getID();
+    if ( id < 0 )
+      return units.exists(u);
+    return slotOf(id) != 0;
+  }
+  bool IndexedUnitset::insert(Unit u)
+  {
+    if ( !u || this->contains(u) )
+      return false;
+
+    units.push_back(u);
+    int id = u->getID();
+    if ( id >= 0 )
+    {
+      if ( id >= (int)slots.size() )
+        slots.resize(id + 1, 0);
+      slots[id] = (int)units.size();
+    }
+    return true;
+  }
+  bool IndexedUnitset::erase(Unit u)
+  {
+    if ( !u )
+      return false;
+
+    iterator pos = units.end();
+    int id = u->getID();
+    if ( id < 0 )
+    {
+      // Units without an ID have no slot and are searched for
+      for ( pos = units.begin(); pos != units.end() && *pos != u; ++pos ) {}
+      if ( pos == units.end() )
+        return false;
+    }
+    else
+    {
+      if ( slotOf(id) == 0 )
+        return false;
+      pos = units.begin() + (slotOf(id) - 1);
+      slots[id] = 0;
+    }
+    int slot = (int)(pos - units.begin()) + 1;
+
+    // The last unit is moved into the erased position
+    iterator it = units.erase(pos);
+    if ( it != units.end() && (*it)->getID() >= 0 )
+      slots[(*it)->getID()] = slot;
+    return true;
+  }
+  void IndexedUnitset::clear()
+  {
+    // Only reset the slots that are in use, so clearing is proportional to the size of the set
+    for ( iterator it = units.begin(); it != units.end(); ++it )
+    {
+      int id = (*it)->getID();
+      if ( id >= 0 && id < (int)slots.size() )
+        slots[id] = 0;
+    }
+    units.clear();
+  }
+  IndexedUnitset &IndexedUnitset::operator =(const Unitset &other)
+  {
+    this->clear();
+    return *this |= other;
+  }
+  IndexedUnitset &IndexedUnitset::operator |=(const Unitset &other)
+  {
+    for ( iterator it = other.begin(); it != other.end(); ++it )
+      this->insert(*it);
+    return *this;
+  }
+  IndexedUnitset &IndexedUnitset::operator &=(const Unitset &other)
+  {
+    return *this = *this & other;
+  }
+  IndexedUnitset &IndexedUnitset::operator -=(const Unitset &other)
+  {
+    for ( iterator it = other.begin(); it != other.end(); ++it )
+      this->erase(*it);
+    return *this;
+  }
+  Unitset IndexedUnitset::operator |(const Unitset &other) const
+  {
+    Unitset result(units.size() + other.size());
+    result.push_back(units);
+    for ( iterator it = other.begin(); it != other.end(); ++it )
+    {
+      if ( !this->contains(*it) )
+        result.push_back(*it);
+    }
+    return result;
+  }
+  Unitset IndexedUnitset::operator &(const Unitset &other) const
+  {
+    // Index the result as it is built, so duplicates in other are only added once
+    IndexedUnitset result(other.size());
+    for ( iterator it = other.begin(); it != other.end(); ++it )
+    {
+      if ( this->contains(*it) )
+        result.insert(*it);
+    }
+    return result.getUnits();
+  }
+  Unitset IndexedUnitset::operator -(const Unitset &other) const
+  {
+    IndexedUnitset otherIndex;
+    otherIndex = other;
+
+    Unitset result(units.size());
+    for ( iterator it = units.begin(); it != units.end(); ++it )
+    {
+      if ( !otherIndex.contains(*it) )
+        result.push_back(*it);
+    }
+    return result;
+  }
+}
@@ -21,10 +21,12 @@ namespace BWAPI
     if ( !this->exists() )
       return Unitset::none;
 
-    return Broodwar->getUnitsInRectangle(this->getLeft()   - radius,
-                                         this->getTop()    - radius,
-                                         this->getRight()  + radius,
-                                         this->getBottom() + radius,
+    // getDistance counts a unit one pixel outside of the rectangle as within radius, so the
+    // rectangle is padded by a pixel to include it
+    return Broodwar->getUnitsInRectangle(this->getLeft()   - radius - 1,
+                                         this->getTop()    - radius - 1,
+                                         this->getRight()  + radius + 1,
+                                         this->getBottom() + radius + 1,
                                          [&](Unit u){ return this != u && this->getDistance(u) <= radius && (!pred.isValid() || pred(u)); });
   }
 
@@ -36,10 +38,10 @@ namespace BWAPI
     
     return Broodwar->getClosestUnitInRectangle(this->getPosition(), 
                                                 [&](Unit u){ return this != u && this->getDistance(u) <= radius && (!pred.isValid() || pred(u)); }, 
-                                                this->getLeft()   - radius,
-                                                this->getTop()    - radius,
-                                                this->getRight()  + radius,
-                                                this->getBottom() + radius);
+                                                this->getLeft()   - radius - 1,
+                                                this->getTop()    - radius - 1,
+                                                this->getRight()  + radius + 1,
+                                                this->getBottom() + radius + 1);
   }
   //--------------------------------------------- GET UNITS IN WEAPON RANGE ----------------------------------
   Unitset UnitInterface::getUnitsInWeaponRange(WeaponType weapon, const UnitFilter &pred) const
@@ -50,10 +52,10 @@ namespace BWAPI
 
     int max = this->getPlayer()->weaponMaxRange(weapon);
 
-    return Broodwar->getUnitsInRectangle(this->getLeft()    - max,
-                                         this->getTop()     - max,
-                                         this->getRight()   + max,
-                                         this->getBottom()  + max,
+    return Broodwar->getUnitsInRectangle(this->getLeft()    - max - 1,
+                                         this->getTop()     - max - 1,
+                                         this->getRight()   + max + 1,
+                                         this->getBottom()  + max + 1,
                                          [&](Unit u)->bool
                                          {
                                           // Unit check and unit status
@@ -17,6 +17,19 @@ namespace BWAPI
   Unitset::Unitset(size_t initialSize) : Vectorset(initialSize) { };
   Unitset::Unitset(const Unitset &other) : Vectorset( other ) { };
   Unitset::Unitset(Unitset &&other) : Vectorset( std::forward<Unitset>(other) ) { };
+  Unitset::Unitset(size_t initialSize, const FrameScoped &tag) : Vectorset(initialSize, tag) { };
+  Unitset::Unitset(Unitset &&other, const FrameScoped &tag) : Vectorset( std::forward<Unitset>(other), tag ) { };
+
+  FrameUnitset::FrameUnitset(size_t initialSize) : Unitset(initialSize, FrameScoped()) { };
+  FrameUnitset::FrameUnitset(const ConstVectorset<Unit> &other) : Unitset(other.size(), FrameScoped())
+  {
+    this->push_back(other);
+  };
+  FrameUnitset::FrameUnitset(const FrameUnitset &other) : Unitset(other.size(), FrameScoped())
+  {
+    this->push_back(other);
+  };
+  FrameUnitset::FrameUnitset(FrameUnitset &&other) : Unitset( std::forward<FrameUnitset>(other), FrameScoped() ) { };
 
   ////////////////////////////////////////////////////////// Position
   Position Unitset::getPosition() const
@@ -0,0 +1,199 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace BWAPI;
+
+namespace Benchmark
+{
+  //------------------------------------------------- TIMER --------------------------------------------------
+  // Returns the current time of the high resolution clock in nanoseconds
+  static long long now()
+  {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / frequency.QuadPart * 1000000000 + counter.QuadPart % frequency.QuadPart * 1000000000 / frequency.QuadPart;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+  }
+  Timer::Timer()
+  {
+    restart();
+  }
+  void Timer::restart()
+  {
+    start = now();
+  }
+  double Timer::elapsedMs() const
+  {
+    return (now() - start) / 1000000.0;
+  }
+  //------------------------------------------------- REPORT -------------------------------------------------
+  void report(const char *benchmark, const char *variant, const char *measure, double value)
+  {
+    printf("%s/%s: %s = %.6g\n", benchmark, variant, measure, value);
+  }
+  //-------------------------------------------- SYNTHETIC MATCH ---------------------------------------------
+  SyntheticMatch::SyntheticMatch(int mapWidth, int mapHeight)
+    : data(new GameData())
+    , staticData(new StaticGameData())
+    , game(nullptr)
+    , unitCount(0)
+  {
+    data->revision   = BWAPI_getRevision();
+    data->isDebug    = BWAPI_isDebug();
+    data->mapWidth   = mapWidth;
+    data->mapHeight  = mapHeight;
+    data->hasGUI     = true;
+    data->forceCount = 1;
+
+    data->playerCount = 12;
+    for ( int i = 0; i < 12; ++i )
+    {
+      PlayerData &p = data->players[i];
+      sprintf(p.name, "Player %d", i);
+      p.force = 0;
+      p.type  = i < 2 ? PlayerTypes::Player : (i == 11 ? PlayerTypes::Neutral : PlayerTypes::None);
+      p.race  = i == 0 ? Races::Protoss : (i == 1 ? Races::Zerg : Races::None);
+      p.isNeutral = i == 11;
+      p.isParticipating = i < 2;
+      p.isAlly[i]  = true;
+      p.supplyTotal[Races::Protoss] = 400;
+      if ( i < 2 )
+        p.isEnemy[1 - i] = true;
+      for ( int t = 0; t < UnitTypes::Enum::MAX; ++t )
+        p.isUnitAvailable[t] = true;
+    }
+    data->self    = 0;
+    data->enemy   = 1;
+    data->neutral = 11;
+
+    for ( int y = 0; y < mapHeight; ++y )
+    {
+      for ( int x = 0; x < mapWidth; ++x )
+      {
+        staticData->isBuildable.set(x, y, true);
+        data->isVisible.set(x, y, true);
+        data->isExplored.set(x, y, true);
+      }
+    }
+    for ( int y = 0; y < mapHeight*4; ++y )
+      for ( int x = 0; x < mapWidth*4; ++x )
+        staticData->isWalkable.set(x, y, true);
+
+    BWAPIClient.data       = data;
+    BWAPIClient.staticData = staticData;
+    game = new GameImpl(data, staticData);
+    BroodwarPtr = game;
+  }
+  SyntheticMatch::~SyntheticMatch()
+  {
+    BroodwarPtr = nullptr;
+    delete game;
+    delete staticData;
+    delete data;
+  }
+  int SyntheticMatch::addUnit(int player, UnitType type, Position position)
+  {
+    int id = unitCount++;
+    UnitData &u = data->units[id];
+    u.id        = id;
+    u.replayID  = id + 1;
+    u.player    = player;
+    u.type      = type;
+    u.positionX = position.x;
+    u.positionY = position.y;
+    u.hitPoints = type.maxHitPoints();
+    u.shields   = type.maxShields();
+    u.resources = type.isResourceContainer() ? 1500 : 0;
+    u.order     = type.isBuilding() ? Orders::Nothing : Orders::PlayerGuard;
+    u.exists      = true;
+    u.isCompleted = true;
+    u.isDetected  = true;
+    u.isIdle      = true;
+    u.isPowered   = true;
+    for ( int i = 0; i < 9; ++i )
+      u.isVisible[i] = true;
+    u.target = u.orderTarget = u.buildUnit = u.addon = u.nydusExit = u.powerUp = -1;
+    u.transport = u.carrier = u.hatchery = u.rallyUnit = -1;
+    return id;
+  }
+  void SyntheticMatch::start()
+  {
+    data->isInGame = true;
+    beginFrame();
+    data->tileChanges.markAll();
+
+    // The first frame discovers every unit
+    for ( int id = 0; id < unitCount; ++id )
+    {
+      BWAPIC::Event &e = data->events[data->eventCount++];
+      e.type = EventType::UnitDiscover;
+      e.v1   = id;
+      e.v2   = 0;
+    }
+    game->onMatchStart();
+  }
+  void SyntheticMatch::beginFrame()
+  {
+    ++data->frameCount;
+    data->eventCount          = 0;
+    data->changedUnitCount    = 0;
+    data->changedPlayerCount  = 0;
+    data->changedBulletCount  = 0;
+    data->frameSyncBytes      = 0;
+    data->shapeCount          = 0;
+    data->commandCount        = 0;
+    data->unitCommandCount    = 0;
+    data->unitCommandGroupUnitCount = 0;
+    data->strings.clear();
+    data->eventStrings.clear();
+    data->tileChanges.clear();
+    updateUnitFinder();
+  }
+  void SyntheticMatch::nextFrame()
+  {
+    beginFrame();
+    game->onMatchFrame();
+  }
+  void SyntheticMatch::updateUnitFinder()
+  {
+    // The left and right edge of each unit in the x array, the top and bottom edge in the y array
+    unitFinder *xf = data->xUnitSearch;
+    unitFinder *yf = data->yUnitSearch;
+    for ( int id = 0; id < unitCount && id < 1700; ++id )
+    {
+      const UnitData &u = data->units[id];
+      if ( !u.exists || u.transport != -1 )
+        continue;
+      UnitType type(u.type);
+      unitFinder edges[4] = {
+        { id, u.positionX - type.dimensionLeft() },
+        { id, u.positionX + type.dimensionRight() },
+        { id, u.positionY - type.dimensionUp() },
+        { id, u.positionY + type.dimensionDown() }
+      };
+      *xf++ = edges[0];
+      *xf++ = edges[1];
+      *yf++ = edges[2];
+      *yf++ = edges[3];
+    }
+    data->unitSearchSize = xf - data->xUnitSearch;
+
+    auto bySearchValue = [](const unitFinder &a, const unitFinder &b){ return a.searchValue < b.searchValue; };
+    std::sort(data->xUnitSearch, xf, bySearchValue);
+    std::sort(data->yUnitSearch, yf, bySearchValue);
+  }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <BWAPI.h>
+#include <BWAPI/Client.h>
+#include <BWAPI/Client/StaticGameData.h>
+
+namespace Benchmark
+{
+  // Measures the wall clock time since it was created or last restarted
+  class Timer
+  {
+  public:
+    Timer();
+    void restart();
+    double elapsedMs() const;
+  private:
+    long long start;
+  };
+
+  // Prints one result line, such as "framesync/full: bytes written per frame = 281600"
+  void report(const char *benchmark, const char *variant, const char *measure, double value);
+
+  // Stands in for the server. It owns a GameData and StaticGameData in regular memory and drives
+  // a client GameImpl with them, so the client side of BWAPI can be timed without StarCraft.
+  // Player 0 is the bot, player 1 its enemy and player 11 is neutral. Every tile of the map is
+  // walkable, buildable, explored and visible.
+  class SyntheticMatch
+  {
+  public:
+    SyntheticMatch(int mapWidth, int mapHeight);
+    ~SyntheticMatch();
+
+    // Adds a completed unit before the match starts, returns its ID
+    int addUnit(int player, BWAPI::UnitType type, BWAPI::Position position);
+
+    // Starts the match, every unit that was added is discovered on the first frame
+    void start();
+
+    // Does what the server does before it publishes a frame: clears the events, change lists and
+    // everything the client wrote for the previous frame, starts a new tile change feed and fills
+    // the unit finder from the current unit data.
+    void beginFrame();
+
+    // Publishes the next frame without changes and runs the client's frame update
+    void nextFrame();
+
+    BWAPI::GameData       *data;
+    BWAPI::StaticGameData *staticData;
+    BWAPI::GameImpl       *game;
+    int unitCount;
+  private:
+    void updateUnitFinder();
+  };
+}
@@ -0,0 +1,44 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Times an overlay that labels every unit, the way debugging bots do. Each frame draws 3000 text
+// shapes: 2000 unit type names, of which there are only 8 different ones, and 1000 labels that are
+// all different. The shared memory used by the strings is compared with the 256 bytes per string
+// of the old fixed slots.
+namespace
+{
+  const int FRAME_COUNT = 200;
+  const int NAME_COUNT = 2000;
+  const int UNIQUE_COUNT = 1000;
+}
+
+void runDrawTextBenchmark()
+{
+  SyntheticMatch match(128, 128);
+  match.start();
+
+  const char *names[8] = { "Zerg Zergling", "Zerg Hydralisk", "Zerg Drone", "Zerg Overlord",
+                           "Protoss Probe", "Protoss Zealot", "Protoss Dragoon", "Protoss Pylon" };
+  GameData *data = match.data;
+  double ms = 0, bytes = 0;
+  for ( int f = 0; f < FRAME_COUNT; ++f )
+  {
+    match.nextFrame();
+
+    Timer timer;
+    for ( int i = 0; i < NAME_COUNT; ++i )
+      Broodwar->drawTextMap(i % 64 * 64, i / 64 * 32, "%s", names[i % 8]);
+    for ( int i = 0; i < UNIQUE_COUNT; ++i )
+      Broodwar->drawTextMap(i % 64 * 64, i / 64 * 32 + 16, "id %d hp %d", f*UNIQUE_COUNT + i, i % 100);
+    ms += timer.elapsedMs();
+    bytes += data->strings.used();
+  }
+
+  report("drawtext", "3000 labels", "us per frame", ms*1000 / FRAME_COUNT);
+  report("drawtext", "3000 labels", "string bytes per frame", bytes / FRAME_COUNT);
+  report("drawtext", "3000 labels", "old slot bytes per frame", (NAME_COUNT + UNIQUE_COUNT)*256.0);
+}
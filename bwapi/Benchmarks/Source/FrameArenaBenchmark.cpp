@@ -0,0 +1,85 @@
+#include "Benchmark.h"
+
+#include <vector>
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Compares temporary Unitsets with FrameUnitsets. 400 units are spread over a 128x128 map. Every
+// frame, each of the bot's 200 units collects the enemy units around it into a set, as a bot
+// looking for targets would. Within 256 pixels the sets stay below the initial size of 16, and
+// within 768 pixels they have to grow.
+//
+// The enemies around each unit are looked up once, so that only the sets are timed. The radius
+// queries themselves are timed by the unitgrid benchmark.
+namespace
+{
+  const int FRAME_COUNT = 1000;
+
+  unsigned int randomState = 4242;
+  int random(int range)
+  {
+    randomState = randomState*1103515245 + 12345;
+    return (randomState >> 16) % range;
+  }
+
+  template <class SetType>
+  void timeFrames(SyntheticMatch &match, const char *variant, const std::vector< std::vector<Unit> > &enemies)
+  {
+    FrameArena::resetCounters();
+
+    int found = 0;
+    double ms = 0;
+    for ( int f = 0; f < FRAME_COUNT; ++f )
+    {
+      match.beginFrame();
+
+      Timer timer;
+      for ( auto list = enemies.begin(); list != enemies.end(); ++list )
+      {
+        SetType set;
+        for ( auto e = list->begin(); e != list->end(); ++e )
+          set.push_back(*e);
+        found += set.size();
+      }
+      ms += timer.elapsedMs();
+    }
+    report("framearena", variant, "us per frame", ms*1000 / FRAME_COUNT);
+    report("framearena", variant, "heap allocations per frame", (double)FrameArena::getHeapAllocations() / FRAME_COUNT);
+    report("framearena", variant, "arena allocations per frame", (double)FrameArena::getArenaAllocations() / FRAME_COUNT);
+    report("framearena", variant, "units per frame", (double)found / FRAME_COUNT);
+  }
+  void findEnemies(int radius, std::vector< std::vector<Unit> > &enemies)
+  {
+    Player self = Broodwar->self();
+    const Unitset &myUnits = self->getUnits();
+    enemies.clear();
+    for ( auto u = myUnits.begin(); u != myUnits.end(); ++u )
+    {
+      enemies.push_back(std::vector<Unit>());
+      Broodwar->forEachUnitInRadius((*u)->getPosition(), radius, [&](Unit v){ if ( v->getPlayer() != self )
+                                                                                 enemies.back().push_back(v); });
+    }
+  }
+}
+
+void runFrameArenaBenchmark()
+{
+  SyntheticMatch match(128, 128);
+  for ( int i = 0; i < 400; ++i )
+  {
+    UnitType type = i % 4 == 0 ? UnitTypes::Protoss_Dragoon : UnitTypes::Zerg_Zergling;
+    match.addUnit(i % 2, type, Position(32 + random(4032), 32 + random(4032)));
+  }
+  match.start();
+  match.nextFrame();
+
+  std::vector< std::vector<Unit> > enemies;
+  findEnemies(256, enemies);
+  timeFrames<Unitset>(match, "Unitset, radius 256", enemies);
+  timeFrames<FrameUnitset>(match, "FrameUnitset, radius 256", enemies);
+
+  findEnemies(768, enemies);
+  timeFrames<Unitset>(match, "Unitset, radius 768", enemies);
+  timeFrames<FrameUnitset>(match, "FrameUnitset, radius 768", enemies);
+}
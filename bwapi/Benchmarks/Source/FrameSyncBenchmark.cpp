@@ -0,0 +1,169 @@
+#include "Benchmark.h"
+#include <BWAPI/Client/FrameSync.h>
+
+#include <vector>
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Compares the full per-frame copy of the unit, player and bullet data with delta sync. A mid
+// game of 440 units is recorded for a number of frames and then replayed twice through the same
+// code the server uses to publish a frame, once in each mode. After each frame the client's
+// onMatchFrame runs, using the change lists in delta mode.
+//
+// In the recorded frames half of each army and every worker is moving or fighting, a fifth of
+// the buildings are training and the mineral fields are mined from. Everything else is idle.
+namespace
+{
+  const int FRAME_COUNT = 240;
+
+  // Deterministic pseudo random numbers, so that every run records the same frames
+  class Random
+  {
+  public:
+    Random() : state(12345) {}
+    int next(int range)
+    {
+      state = state*1103515245 + 12345;
+      return (state >> 16) % range;
+    }
+  private:
+    unsigned int state;
+  };
+
+  void addArmy(SyntheticMatch &match, Random &random, int player, Position base)
+  {
+    UnitType building = player == 0 ? UnitTypes::Protoss_Gateway : UnitTypes::Zerg_Hatchery;
+    UnitType worker   = player == 0 ? UnitTypes::Protoss_Probe   : UnitTypes::Zerg_Drone;
+    UnitType soldier  = player == 0 ? UnitTypes::Protoss_Dragoon : UnitTypes::Zerg_Zergling;
+    for ( int i = 0; i < 30; ++i )
+      match.addUnit(player, building, base + Position((i % 6)*160, (i / 6)*128));
+    for ( int i = 0; i < 40; ++i )
+      match.addUnit(player, worker, base + Position(random.next(900), 700 + random.next(200)));
+    for ( int i = 0; i < 120; ++i )
+      match.addUnit(player, soldier, Position(1800 + random.next(500), 1800 + random.next(500)));
+  }
+
+  // Advances the unit data by one frame
+  void simulateFrame(UnitData *units, int unitCount, Random &random)
+  {
+    for ( int id = 0; id < unitCount; ++id )
+    {
+      UnitData &u = units[id];
+      UnitType type(u.type);
+      if ( type.isResourceContainer() )
+      {
+        // Each field is mined from about every 40 frames
+        if ( random.next(40) == 0 )
+          u.resources -= 8;
+        continue;
+      }
+      if ( type.isBuilding() )
+      {
+        // A fifth of the buildings are training
+        if ( id % 5 == 0 )
+        {
+          u.isTraining = true;
+          u.remainingTrainTime = u.remainingTrainTime > 0 ? u.remainingTrainTime - 1 : 600;
+        }
+        continue;
+      }
+      // Half of the army is idle
+      if ( !type.isWorker() && id % 2 == 0 )
+        continue;
+
+      u.isMoving   = true;
+      u.isIdle     = false;
+      u.order      = Orders::AttackMove;
+      u.orderTimer = u.orderTimer > 0 ? u.orderTimer - 1 : 8;
+      u.velocityX  = random.next(9) - 4;
+      u.velocityY  = random.next(9) - 4;
+      u.positionX += (int)u.velocityX;
+      u.positionY += (int)u.velocityY;
+      u.angle      = random.next(256) / 40.0;
+      if ( random.next(8) == 0 && u.hitPoints > 1 )
+      {
+        u.lastHitPoints = u.hitPoints;
+        u.hitPoints    -= 1;
+        u.groundWeaponCooldown = 20;
+      }
+      else if ( u.groundWeaponCooldown > 0 )
+        --u.groundWeaponCooldown;
+    }
+  }
+
+  void replay(SyntheticMatch &match, const std::vector<UnitData> &frames, bool deltaSync)
+  {
+    GameData *data = match.data;
+    int unitCount  = match.unitCount;
+    const char *variant = deltaSync ? "delta" : "full";
+
+    // Start from the first recorded frame with a full update, as after the match start
+    match.beginFrame();
+    memcpy(data->units, &frames[0], unitCount*sizeof(UnitData));
+    data->hasFrameDelta = false;
+    match.game->onMatchFrame();
+
+    double bytes = 0, serverMs = 0, clientMs = 0;
+    Timer timer;
+    for ( int f = 1; f < FRAME_COUNT; ++f )
+    {
+      match.beginFrame();
+      data->hasFrameDelta = deltaSync;
+
+      // What Server::updateSharedMemory writes for units, players and bullets
+      timer.restart();
+      const UnitData *next = &frames[f*unitCount];
+      for ( int id = 0; id < unitCount; ++id )
+        data->frameSyncBytes += syncFrameSlot(data->units[id], next[id], id, deltaSync, data->changedUnits, data->changedUnitCount);
+      for ( int id = 0; id < 12; ++id )
+      {
+        PlayerData player = data->players[id];
+        if ( id < 2 )
+          player.minerals += 8*(f % 5 == 0);
+        data->frameSyncBytes += syncFrameSlot(data->players[id], player, id, deltaSync, data->changedPlayers, data->changedPlayerCount);
+      }
+      for ( int id = 0; id < 100; ++id )
+      {
+        BulletData bullet = data->bullets[id];
+        data->frameSyncBytes += syncFrameSlot(data->bullets[id], bullet, id, deltaSync, data->changedBullets, data->changedBulletCount);
+      }
+      serverMs += timer.elapsedMs();
+
+      timer.restart();
+      match.game->onMatchFrame();
+      clientMs += timer.elapsedMs();
+      bytes += data->frameSyncBytes;
+    }
+
+    int frames_ = FRAME_COUNT - 1;
+    report("framesync", variant, "bytes written per frame", bytes / frames_);
+    report("framesync", variant, "server us per frame", serverMs*1000 / frames_);
+    report("framesync", variant, "client onMatchFrame us per frame", clientMs*1000 / frames_);
+  }
+}
+
+void runFrameSyncBenchmark()
+{
+  SyntheticMatch match(128, 128);
+  Random random;
+  addArmy(match, random, 0, Position(300, 300));
+  addArmy(match, random, 1, Position(2900, 2900));
+  for ( int i = 0; i < 56; ++i )
+    match.addUnit(11, UnitTypes::Resource_Mineral_Field, Position(200 + (i % 28)*64, 100 + (i / 28)*3700));
+  for ( int i = 0; i < 4; ++i )
+    match.addUnit(11, UnitTypes::Resource_Vespene_Geyser, Position(600 + i*800, 2000));
+  match.start();
+
+  // Record the frames
+  std::vector<UnitData> frames(FRAME_COUNT*match.unitCount);
+  memcpy(&frames[0], match.data->units, match.unitCount*sizeof(UnitData));
+  for ( int f = 1; f < FRAME_COUNT; ++f )
+  {
+    memcpy(&frames[f*match.unitCount], &frames[(f - 1)*match.unitCount], match.unitCount*sizeof(UnitData));
+    simulateFrame(&frames[f*match.unitCount], match.unitCount, random);
+  }
+
+  replay(match, frames, false);
+  replay(match, frames, true);
+}
@@ -0,0 +1,110 @@
+#include "Benchmark.h"
+#include "StandInServer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Times the frame handoff of the POSIX transport. This process runs a stand-in server and forks a
+// bot process that connects to it with the client, and finishes every frame as soon as it gets it.
+// A round trip is the time from the server publishing a frame until the bot has handed it back,
+// which is what the pipe codes 2 and 1 cost with the Windows transport.
+#ifndef _WIN32
+namespace
+{
+  const int FRAME_COUNT = 20000;
+  const int TIMEOUT_MS  = 5000;
+
+  // The bot process, never returns
+  void runBot(int spinIterations)
+  {
+    // The client prints the game table while connecting, keep it out of the results
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, 1);
+
+    // The client side objects read the game data through the global client
+    Client &client = BWAPIClient;
+    client.setSpinIterations(spinIterations);
+    if ( !client.connect() )
+      _exit(1);
+    for ( int i = 0; i < FRAME_COUNT && client.isConnected(); ++i )
+      client.update();
+    bool connected = client.isConnected();
+    client.disconnect();
+    _exit(connected ? 0 : 1);
+  }
+  void timeHandoff(const char *variant, int spinIterations)
+  {
+    StandInServer server;
+    if ( !server.isReady() )
+    {
+      printf("handoff/%s: unable to create the shared memory\n", variant);
+      return;
+    }
+
+    fflush(stdout);
+    std::cout.flush();
+    pid_t bot = fork();
+    if ( bot == 0 )
+      runBot(spinIterations);
+
+    std::vector<double> roundTrips;
+    roundTrips.reserve(FRAME_COUNT);
+    bool ok = server.waitForClient(TIMEOUT_MS);
+    Timer timer;
+    while ( ok && (int)roundTrips.size() < FRAME_COUNT )
+    {
+      timer.restart();
+      server.publishFrame();
+      ok = server.waitForFrameDone(TIMEOUT_MS);
+      roundTrips.push_back(timer.elapsedMs()*1000);
+    }
+
+    // Keep publishing until the bot has returned from its last update
+    int status = 0;
+    while ( ok && waitpid(bot, &status, WNOHANG) == 0 )
+    {
+      server.publishFrame();
+      server.waitForFrameDone(10);
+    }
+    if ( !ok )
+    {
+      kill(bot, SIGKILL);
+      waitpid(bot, &status, 0);
+      printf("handoff/%s: the bot stopped answering after %d frames\n", variant, (int)roundTrips.size());
+      return;
+    }
+
+    std::sort(roundTrips.begin(), roundTrips.end());
+    double total = 0;
+    for ( auto t = roundTrips.begin(); t != roundTrips.end(); ++t )
+      total += *t;
+    report("handoff", variant, "us per round trip", total / roundTrips.size());
+    report("handoff", variant, "median us", roundTrips[roundTrips.size() / 2]);
+    report("handoff", variant, "99th percentile us", roundTrips[roundTrips.size() * 99 / 100]);
+    report("handoff", variant, "bot exit status", WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+  }
+}
+
+void runHandoffBenchmark()
+{
+  timeHandoff("blocking", 0);
+  timeHandoff("spin 10000", 10000);
+}
+#else
+void runHandoffBenchmark()
+{
+  printf("handoff: needs the POSIX transport, the Windows client hands frames off with the pipe\n");
+}
+#endif
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstring>
+
+// Each benchmark prints its results with Benchmark::report
+void runDrawTextBenchmark();
+void runFilterBenchmark();
+void runFrameArenaBenchmark();
+void runFrameSyncBenchmark();
+void runHandoffBenchmark();
+void runPlacementBenchmark();
+void runPowerBenchmark();
+void runUnitFinderBenchmark();
+void runUnitGridBenchmark();
+
+struct BenchmarkEntry
+{
+  const char *name;
+  void (*run)();
+};
+static const BenchmarkEntry benchmarks[] = {
+  { "drawtext",   &runDrawTextBenchmark },
+  { "filter",     &runFilterBenchmark },
+  { "framearena", &runFrameArenaBenchmark },
+  { "framesync",  &runFrameSyncBenchmark },
+  { "handoff",    &runHandoffBenchmark },
+  { "placement",  &runPlacementBenchmark },
+  { "power",      &runPowerBenchmark },
+  { "unitfinder", &runUnitFinderBenchmark },
+  { "unitgrid",   &runUnitGridBenchmark }
+};
+static const int benchmarkCount = sizeof(benchmarks)/sizeof(benchmarks[0]);
+
+// Runs the benchmarks named on the command line, or all of them
+int main(int argc, const char* argv[])
+{
+  int ran = 0;
+  for ( int i = 0; i < benchmarkCount; ++i )
+  {
+    bool selected = argc < 2;
+    for ( int a = 1; a < argc; ++a )
+    {
+      if ( strcmp(argv[a], benchmarks[i].name) == 0 )
+        selected = true;
+    }
+    if ( !selected )
+      continue;
+    benchmarks[i].run();
+    ++ran;
+  }
+
+  if ( ran == 0 )
+  {
+    printf("usage: %s [benchmark...]\nbenchmarks:", argv[0]);
+    for ( int i = 0; i < benchmarkCount; ++i )
+      printf(" %s", benchmarks[i].name);
+    printf("\n");
+    return 1;
+  }
+  return 0;
+}
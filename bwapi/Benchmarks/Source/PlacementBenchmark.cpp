@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Times structure placement queries on a 128x128 map with two bases of 30 buildings and 200 units
+// in the middle. Every frame the bot checks 2000 random candidate positions with canBuildHere and
+// asks getBuildLocation for 4 structures around its base. Every 10 frames a structure is placed
+// or removed, which the tile change feed reports like the server would.
+namespace
+{
+  const int FRAME_COUNT = 100;
+  const int CHECKS_PER_FRAME = 2000;
+  const int LOCATIONS_PER_FRAME = 4;
+
+  unsigned int randomState = 31337;
+  int random(int range)
+  {
+    randomState = randomState*1103515245 + 12345;
+    return (randomState >> 16) % range;
+  }
+
+  // Marks the footprint of a structure as occupied or free and reports the change in the feed
+  void setOccupied(GameData *data, TilePosition position, UnitType type, bool occupied)
+  {
+    typedef TileChangeFeed::Word Word;
+    for ( int y = position.y; y < position.y + type.tileHeight(); ++y )
+    {
+      for ( int x = position.x; x < position.x + type.tileWidth(); ++x )
+      {
+        data->isOccupied.set(x, y, occupied);
+        data->tileChanges.addWord(y, x / TileLayer<256,256>::WORD_BITS, 0, 0, 0, (Word)1 << (x % TileLayer<256,256>::WORD_BITS));
+      }
+    }
+  }
+
+  void addBase(SyntheticMatch &match, int player, TilePosition base)
+  {
+    UnitType type = UnitTypes::Terran_Barracks;
+    for ( int i = 0; i < 30; ++i )
+    {
+      TilePosition tile = base + TilePosition((i % 6)*5, (i / 6)*4);
+      match.addUnit(player, type, Position(tile) + Position(type.tileWidth()*16, type.tileHeight()*16));
+      setOccupied(match.data, tile, type, true);
+    }
+  }
+}
+
+void runPlacementBenchmark()
+{
+  SyntheticMatch match(128, 128);
+  addBase(match, 0, TilePosition(8, 8));
+  addBase(match, 1, TilePosition(90, 100));
+  for ( int i = 0; i < 200; ++i )
+    match.addUnit(i % 2, UnitTypes::Terran_Marine, Position(1200 + random(1600), 1200 + random(1600)));
+  match.start();
+
+  // The first query of each footprint builds its part of the cache, time it separately
+  Timer timer;
+  Broodwar->canBuildHere(TilePosition(60, 60), UnitTypes::Terran_Barracks);
+  Broodwar->canBuildHere(TilePosition(60, 60), UnitTypes::Terran_Supply_Depot);
+  report("placement", "first query", "us", timer.elapsedMs()*1000);
+
+  int buildable = 0, located = 0;
+  double checkMs = 0, locationMs = 0;
+  TilePosition toggled(40, 20);
+  for ( int f = 0; f < FRAME_COUNT; ++f )
+  {
+    match.beginFrame();
+    if ( f % 10 == 5 )
+      setOccupied(match.data, toggled, UnitTypes::Terran_Barracks, f % 20 == 5);
+    match.game->onMatchFrame();
+
+    timer.restart();
+    for ( int i = 0; i < CHECKS_PER_FRAME; ++i )
+    {
+      UnitType type = i % 2 ? UnitTypes::Terran_Barracks : UnitTypes::Terran_Supply_Depot;
+      if ( Broodwar->canBuildHere(TilePosition(random(125), random(125)), type) )
+        ++buildable;
+    }
+    checkMs += timer.elapsedMs();
+
+    timer.restart();
+    for ( int i = 0; i < LOCATIONS_PER_FRAME; ++i )
+    {
+      UnitType type = i % 2 ? UnitTypes::Terran_Barracks : UnitTypes::Terran_Supply_Depot;
+      if ( Broodwar->getBuildLocation(type, TilePosition(20 + random(8), 16 + random(8))) != TilePositions::Invalid )
+        ++located;
+    }
+    locationMs += timer.elapsedMs();
+  }
+  report("placement", "canBuildHere", "ns per call", checkMs*1000000 / (FRAME_COUNT*CHECKS_PER_FRAME));
+  report("placement", "canBuildHere", "buildable per frame", (double)buildable / FRAME_COUNT);
+  report("placement", "getBuildLocation", "us per call", locationMs*1000 / (FRAME_COUNT*LOCATIONS_PER_FRAME));
+  report("placement", "getBuildLocation", "found per frame", (double)located / FRAME_COUNT);
+}
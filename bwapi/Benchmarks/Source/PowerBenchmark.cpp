@@ -0,0 +1,58 @@
+#include "Benchmark.h"
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Times power queries with 40 completed pylons spread over a 128x128 map, as a Protoss bot late in
+// the game would have. The queries are made at random positions: hasPower by tile, hasPowerPrecise
+// by pixel, and canBuildHere for a gateway, which checks power as well.
+namespace
+{
+  const int QUERY_COUNT = 200000;
+
+  unsigned int randomState = 99;
+  int random(int range)
+  {
+    randomState = randomState*1103515245 + 12345;
+    return (randomState >> 16) % range;
+  }
+}
+
+void runPowerBenchmark()
+{
+  SyntheticMatch match(128, 128);
+  for ( int i = 0; i < 40; ++i )
+    match.addUnit(0, UnitTypes::Protoss_Pylon, Position(TilePosition(4 + (i % 8)*15, 4 + (i / 8)*24)) + Position(32, 32));
+  match.start();
+  match.nextFrame();
+
+  int powered = 0;
+  Timer timer;
+  for ( int i = 0; i < QUERY_COUNT; ++i )
+  {
+    if ( Broodwar->hasPower(random(126), random(126), UnitTypes::Protoss_Gateway) )
+      ++powered;
+  }
+  report("power", "hasPower", "ns per call", timer.elapsedMs()*1000000 / QUERY_COUNT);
+  report("power", "hasPower", "powered", powered);
+
+  powered = 0;
+  timer.restart();
+  for ( int i = 0; i < QUERY_COUNT; ++i )
+  {
+    if ( Broodwar->hasPowerPrecise(random(4096), random(4096)) )
+      ++powered;
+  }
+  report("power", "hasPowerPrecise", "ns per call", timer.elapsedMs()*1000000 / QUERY_COUNT);
+  report("power", "hasPowerPrecise", "powered", powered);
+
+  int buildable = 0;
+  timer.restart();
+  for ( int i = 0; i < QUERY_COUNT; ++i )
+  {
+    if ( Broodwar->canBuildHere(TilePosition(random(124), random(125)), UnitTypes::Protoss_Gateway) )
+      ++buildable;
+  }
+  report("power", "canBuildHere gateway", "ns per call", timer.elapsedMs()*1000000 / QUERY_COUNT);
+  report("power", "canBuildHere gateway", "buildable", buildable);
+}
@@ -0,0 +1,199 @@
+#include "StandInServer.h"
+
+#include <BWAPI.h>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <BWAPI/Client/FrameHandoff.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#endif
+
+using namespace BWAPI;
+
+namespace Benchmark
+{
+#ifndef _WIN32
+  //------------------------------------------ CREATE SHARED MEMORY ------------------------------------------
+  // Opens or creates a mapping, created is set if it did not exist yet and is all zeroes
+  static void *createSharedMemory(const std::string &name, size_t size, bool &created)
+  {
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0666);
+    if ( fd == -1 )
+      return nullptr;
+    struct stat st;
+    created = fstat(fd, &st) == 0 && st.st_size == 0;
+    if ( created && ftruncate(fd, size) == -1 )
+    {
+      close(fd);
+      return nullptr;
+    }
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return mem == MAP_FAILED ? nullptr : mem;
+  }
+  static std::string sharedMemoryName(const char *prefix, unsigned int processID)
+  {
+    std::stringstream name;
+    name << prefix << processID;
+    return name.str();
+  }
+  // Milliseconds of the monotonic clock, in place of GetTickCount for the keep alive time
+  static unsigned int tickCount()
+  {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned int)(now.tv_sec*1000 + now.tv_nsec/1000000);
+  }
+  static bool isProcessGone(unsigned int processID)
+  {
+    return kill((pid_t)processID, 0) == -1 && errno == ESRCH;
+  }
+
+  StandInServer::StandInServer()
+    : data(nullptr)
+    , staticData(nullptr)
+    , gameTable(nullptr)
+    , gameTableIndex(-1)
+    , processID(getpid())
+  {
+    bool created = false;
+    gameTable = (GameTable*)createSharedMemory("/bwapi_shared_memory_game_list", sizeof(GameTable), created);
+    if ( !gameTable )
+      return;
+
+    // Take a free row or the row of a server that has exited, else the oldest one as the server does
+    for ( int i = 0; i < GameTable::MAX_GAME_INSTANCES && gameTableIndex == -1; ++i )
+    {
+      unsigned int owner = gameTable->gameInstances[i].serverProcessID;
+      if ( owner == 0 || owner == processID || isProcessGone(owner) )
+        gameTableIndex = i;
+    }
+    if ( gameTableIndex == -1 )
+    {
+      gameTableIndex = 0;
+      for ( int i = 1; i < GameTable::MAX_GAME_INSTANCES; ++i )
+      {
+        if ( gameTable->gameInstances[i].lastKeepAliveTime < gameTable->gameInstances[gameTableIndex].lastKeepAliveTime )
+          gameTableIndex = i;
+      }
+    }
+
+    // Map the game data before the row is published, a client connects as soon as it sees it
+    data = (GameData*)createSharedMemory(sharedMemoryName("/bwapi_shared_memory_", processID), sizeof(GameData), created);
+    staticData = (StaticGameData*)createSharedMemory(sharedMemoryName("/bwapi_shared_memory_static_", processID), sizeof(StaticGameData), created);
+    if ( !data || !staticData )
+      return;
+
+    data->revision         = BWAPI_getRevision();
+    data->isDebug          = BWAPI_isDebug();
+    data->frameSequence    = 0;
+    data->clientSequence   = 0;
+    data->frameLock        = 0;
+    data->eventCount       = 0;
+    data->eventStrings.clear();
+    data->strings.clear();
+    data->hasGUI           = false;
+    staticData->revision   = BWAPI_getRevision();
+    staticData->generation = 0;
+
+    GameInstance &instance = gameTable->gameInstances[gameTableIndex];
+    instance = GameInstance(processID, false, tickCount());
+  }
+  StandInServer::~StandInServer()
+  {
+    if ( gameTable )
+    {
+      bool tableInUse = false;
+      for ( int i = 0; i < GameTable::MAX_GAME_INSTANCES; ++i )
+      {
+        if ( i == gameTableIndex )
+          gameTable->gameInstances[i] = GameInstance();
+        else if ( gameTable->gameInstances[i].serverProcessID != 0 )
+          tableInUse = true;
+      }
+      munmap(gameTable, sizeof(GameTable));
+      if ( !tableInUse )
+        shm_unlink("/bwapi_shared_memory_game_list");
+    }
+    if ( data )
+      munmap(data, sizeof(GameData));
+    if ( staticData )
+      munmap(staticData, sizeof(StaticGameData));
+    shm_unlink(sharedMemoryName("/bwapi_shared_memory_", processID).c_str());
+    shm_unlink(sharedMemoryName("/bwapi_shared_memory_static_", processID).c_str());
+  }
+  bool StandInServer::isReady() const
+  {
+    return gameTable && gameTableIndex != -1 && data && staticData;
+  }
+  bool StandInServer::waitForClient(int timeoutMs)
+  {
+    unsigned int start = tickCount();
+    while ( !__atomic_load_n(&gameTable->gameInstances[gameTableIndex].isConnected, __ATOMIC_ACQUIRE) )
+    {
+      if ( tickCount() - start >= (unsigned int)timeoutMs )
+        return false;
+      gameTable->gameInstances[gameTableIndex].lastKeepAliveTime = tickCount();
+      usleep(1000);
+    }
+    return waitForFrameDone(timeoutMs);
+  }
+  void StandInServer::publishFrame()
+  {
+    // Same order as Server::update, the frame lock is odd while the frame is rewritten
+    __atomic_add_fetch(&data->frameLock, 1, __ATOMIC_ACQ_REL);
+    data->strings.clear();
+    data->commandCount     = 0;
+    data->unitCommandCount = 0;
+    data->unitCommandGroupUnitCount = 0;
+    data->shapeCount       = 0;
+    data->eventCount       = 0;
+    ++data->frameCount;
+    gameTable->gameInstances[gameTableIndex].lastKeepAliveTime = tickCount();
+    __atomic_add_fetch(&data->frameLock, 1, __ATOMIC_ACQ_REL);
+
+    setSequence(&data->frameSequence, data->frameSequence + 1);
+  }
+  bool StandInServer::waitForFrameDone(int timeoutMs)
+  {
+    unsigned int frame = data->frameSequence;
+    unsigned int done;
+    while ( (done = __atomic_load_n(&data->clientSequence, __ATOMIC_ACQUIRE)) != frame )
+    {
+      if ( !waitForSequence(&data->clientSequence, done, timeoutMs) )
+        return false;
+    }
+    return true;
+  }
+#else
+  StandInServer::StandInServer()
+    : data(nullptr)
+    , staticData(nullptr)
+    , gameTable(nullptr)
+    , gameTableIndex(-1)
+    , processID(0)
+  {}
+  StandInServer::~StandInServer()
+  {}
+  bool StandInServer::isReady() const
+  {
+    return false;
+  }
+  bool StandInServer::waitForClient(int)
+  {
+    return false;
+  }
+  void StandInServer::publishFrame()
+  {}
+  bool StandInServer::waitForFrameDone(int)
+  {
+    return false;
+  }
+#endif
+}
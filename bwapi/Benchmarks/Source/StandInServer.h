@@ -0,0 +1,39 @@
+#pragma once
+#include <BWAPI/Client/GameData.h>
+#include <BWAPI/Client/StaticGameData.h>
+#include <BWAPI/Client/GameTable.h>
+
+namespace Benchmark
+{
+  // Stands in for the BWAPI server on POSIX systems, so that a client process can be connected
+  // with the POSIX transport without StarCraft. It creates the game table, GameData and
+  // StaticGameData mappings under the names ClientPosix looks for, takes a row of the game table
+  // for its process and hands frames to the client with the GameData sequence numbers, as the
+  // server does with the pipe on Windows. The frames it publishes carry no events.
+  // Only available where the POSIX transport is, isReady is false everywhere else.
+  class StandInServer
+  {
+  public:
+    StandInServer();
+    ~StandInServer();
+
+    // True if every mapping was created and the server has a game table row
+    bool isReady() const;
+
+    // Waits until a client has claimed the row and acknowledged the frames published so far
+    bool waitForClient(int timeoutMs);
+
+    // Clears what the client wrote for the last frame and publishes the next one
+    void publishFrame();
+
+    // Waits until the client has finished the last published frame, false on timeout
+    bool waitForFrameDone(int timeoutMs);
+
+    BWAPI::GameData       *data;
+    BWAPI::StaticGameData *staticData;
+  private:
+    BWAPI::GameTable *gameTable;
+    int gameTableIndex;
+    unsigned int processID;
+  };
+}
@@ -0,0 +1,56 @@
+#include "Benchmark.h"
+#include "../../BWAPIClient/Source/TemplatesImpl.h"
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Times rectangle queries that go through the sorted unit finder, which is what the server and
+// the client use before a unit grid has been built for the frame. 1600 units are spread over a
+// 128x128 map. Small rectangles are 96 pixels wide, about the size of a splash, and large ones
+// are 1024 pixels wide.
+namespace
+{
+  unsigned int randomState = 2024;
+  int random(int range)
+  {
+    randomState = randomState*1103515245 + 12345;
+    return (randomState >> 16) % range;
+  }
+
+  void timeQueries(SyntheticMatch &match, const char *variant, int size, int queryCount)
+  {
+    GameData *data = match.data;
+    int found = 0;
+    Timer timer;
+    for ( int i = 0; i < queryCount; ++i )
+    {
+      int left = random(4096 - size), top = random(4096 - size);
+      Templates::iterateUnitFinder<unitFinder>(data->xUnitSearch,
+                                               data->yUnitSearch,
+                                               data->unitSearchSize,
+                                               left,
+                                               top,
+                                               left + size,
+                                               top + size,
+                                               [&](Unit){ ++found; });
+    }
+    double ms = timer.elapsedMs();
+    report("unitfinder", variant, "ns per query", ms*1000000 / queryCount);
+    report("unitfinder", variant, "units found per query", (double)found / queryCount);
+  }
+}
+
+void runUnitFinderBenchmark()
+{
+  SyntheticMatch match(128, 128);
+  for ( int i = 0; i < 1600; ++i )
+  {
+    UnitType type = i % 4 == 0 ? UnitTypes::Protoss_Dragoon : UnitTypes::Zerg_Zergling;
+    match.addUnit(i % 2, type, Position(32 + random(4032), 32 + random(4032)));
+  }
+  match.start();
+  match.nextFrame();
+
+  timeQueries(match, "small", 96, 200000);
+  timeQueries(match, "large", 1024, 20000);
+}
@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+
+using namespace BWAPI;
+using namespace Benchmark;
+
+// Times the radius queries a bot makes every frame, such as looking for targets around each of its
+// units. 400 units are spread over a 128x128 map and the queries go through Broodwar, so they use
+// the unit grid the client builds in onMatchFrame.
+namespace
+{
+  unsigned int randomState = 77;
+  int random(int range)
+  {
+    randomState = randomState*1103515245 + 12345;
+    return (randomState >> 16) % range;
+  }
+
+  void timeRadiusQueries(const char *variant, int radius, int queryCount)
+  {
+    int found = 0;
+    Timer timer;
+    for ( int i = 0; i < queryCount; ++i )
+    {
+      Position center(random(4096), random(4096));
+      found += Broodwar->getUnitsInRadius(center, radius).size();
+    }
+    double ms = timer.elapsedMs();
+    report("unitgrid", variant, "ns per getUnitsInRadius", ms*1000000 / queryCount);
+    report("unitgrid", variant, "units found per query", (double)found / queryCount);
+  }
+  void timeVisitQueries(const char *variant, int radius, int queryCount)
+  {
+    int found = 0;
+    Timer timer;
+    for ( int i = 0; i < queryCount; ++i )
+    {
+      Position center(random(4096), random(4096));
+      Broodwar->forEachUnitInRadius(center, radius, [&](Unit){ ++found; });
+    }
+    double ms = timer.elapsedMs();
+    report("unitgrid", variant, "ns per forEachUnitInRadius", ms*1000000 / queryCount);
+    report("unitgrid", variant, "units visited per query", (double)found / queryCount);
+  }
+  void timeClosestQueries(const char *variant, int radius, int queryCount)
+  {
+    int found = 0;
+    Timer timer;
+    for ( int i = 0; i < queryCount; ++i )
+    {
+      Position center(random(4096), random(4096));
+      if ( Broodwar->getClosestUnit(center, Filter::IsEnemy, radius) )
+        ++found;
+    }
+    double ms = timer.elapsedMs();
+    report("unitgrid", variant, "ns per getClosestUnit", ms*1000000 / queryCount);
+    report("unitgrid", variant, "queries with a result", (double)found / queryCount);
+  }
+}
+
+void runUnitGridBenchmark()
+{
+  SyntheticMatch match(128, 128);
+  for ( int i = 0; i < 400; ++i )
+  {
+    UnitType type = i % 4 == 0 ? UnitTypes::Protoss_Dragoon : UnitTypes::Zerg_Zergling;
+    match.addUnit(i % 2, type, Position(32 + random(4032), 32 + random(4032)));
+  }
+  match.start();
+  match.nextFrame();
+
+  timeRadiusQueries("radius 256", 256, 100000);
+  timeRadiusQueries("radius 1024", 1024, 20000);
+  timeVisitQueries("radius 256", 256, 100000);
+  timeVisitQueries("radius 1024", 1024, 20000);
+  timeClosestQueries("radius 256", 256, 100000);
+  timeClosestQueries("radius 1024", 1024, 20000);
+}
@@ -2,8 +2,270 @@
 #include <GameImpl.h>
 #include <TemplatesImpl.h>
 
+#include <queue>
+#include <functional>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CLEARANCE_SSE2
+#endif
+
 namespace BWAPI
 {
+  //------------------------------------------ RELAX CLEARANCE ROW -------------------------------------------
+  // Lowers the clearance of each tile in [first, last] of row to one more than the lowest of its
+  // three neighbors in the adjacent row. Clearance saturates at 255.
+  static void relaxClearanceRow(unsigned char *row, const unsigned char *adjacent, int first, int last)
+  {
+    int x = first;
+#ifdef CLEARANCE_SSE2
+    const __m128i one = _mm_set1_epi8(1);
+    for ( ; x + 16 <= last + 1; x += 16 )
+    {
+      __m128i lowest = _mm_min_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&adjacent[x - 1])),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(&adjacent[x])));
+      lowest = _mm_min_epu8(lowest, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&adjacent[x + 1])));
+      lowest = _mm_adds_epu8(lowest, one);
+      __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[x]));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&row[x]), _mm_min_epu8(current, lowest));
+    }
+#endif
+    for ( ; x <= last; ++x )
+    {
+      int lowest = adjacent[x - 1];
+      if ( adjacent[x] < lowest )
+        lowest = adjacent[x];
+      if ( adjacent[x + 1] < lowest )
+        lowest = adjacent[x + 1];
+      if ( lowest + 1 < row[x] )
+        row[x] = (unsigned char)(lowest + 1);
+    }
+  }
+  //-------------------------------------------- COMPUTE CLEARANCE -------------------------------------------
+  void GameImpl::_computeClearance()
+  {
+    int width  = this->mapWidth()*4;
+    int height = this->mapHeight()*4;
+
+    // The grid has a border of unwalkable tiles, so the map edge counts as an obstacle and the
+    // passes need no bounds checks
+    int stride = width + 2;
+    std::vector<unsigned char> grid(stride*(height + 2), 0);
+    for ( int y = 0; y < height; ++y )
+      for ( int x = 0; x < width; ++x )
+        grid[(y + 1)*stride + x + 1] = this->isWalkable(x, y) ? 255 : 0;
+
+    // Two pass chessboard distance transform. Each pass relaxes a whole row against the previous
+    // one, which is vectorized, and then scans along the row.
+    for ( int y = 1; y <= height; ++y )
+    {
+      unsigned char *row = &grid[y*stride];
+      relaxClearanceRow(row, row - stride, 1, width);
+      for ( int x = 1; x <= width; ++x )
+      {
+        if ( row[x - 1] + 1 < row[x] )
+          row[x] = (unsigned char)(row[x - 1] + 1);
+      }
+    }
+    for ( int y = height; y >= 1; --y )
+    {
+      unsigned char *row = &grid[y*stride];
+      relaxClearanceRow(row, row + stride, 1, width);
+      for ( int x = width; x >= 1; --x )
+      {
+        if ( row[x + 1] + 1 < row[x] )
+          row[x] = (unsigned char)(row[x + 1] + 1);
+      }
+    }
+
+    clearance.resize(width*height);
+    for ( int y = 0; y < height; ++y )
+      memcpy(&clearance[y*width], &grid[(y + 1)*stride + 1], width);
+  }
+  //--------------------------------------------- GET CLEARANCE ----------------------------------------------
+  int GameImpl::getClearance(int x, int y) const
+  {
+    int width = this->mapWidth()*4;
+    if ( x < 0 || y < 0 || x >= width || y >= this->mapHeight()*4 || clearance.empty() )
+      return 0;
+    return clearance[y*width + x];
+  }
+  //------------------------------------------ GET CLEARANCE AREAS -------------------------------------------
+  const std::vector<int> &GameImpl::_getClearanceAreas(int minClearance) const
+  {
+    std::vector<int> &areas = clearanceAreas[minClearance - 1];
+    if ( !areas.empty() || clearance.empty() )
+      return areas;
+
+    // Flood fill the tiles with enough clearance
+    int width  = this->mapWidth()*4;
+    int height = this->mapHeight()*4;
+    areas.assign(width*height, 0);
+
+    std::vector<int> open;
+    int nextArea = 1;
+    for ( int i = 0; i < width*height; ++i )
+    {
+      if ( areas[i] != 0 || clearance[i] < minClearance )
+        continue;
+
+      areas[i] = nextArea;
+      open.push_back(i);
+      while ( !open.empty() )
+      {
+        int tile = open.back();
+        open.pop_back();
+
+        int x = tile % width, y = tile / width;
+        int neighbors[4] = { x > 0 ? tile - 1 : -1,
+                             x < width - 1 ? tile + 1 : -1,
+                             y > 0 ? tile - width : -1,
+                             y < height - 1 ? tile + width : -1 };
+        for ( int n = 0; n < 4; ++n )
+        {
+          if ( neighbors[n] != -1 && areas[neighbors[n]] == 0 && clearance[neighbors[n]] >= minClearance )
+          {
+            areas[neighbors[n]] = nextArea;
+            open.push_back(neighbors[n]);
+          }
+        }
+      }
+      ++nextArea;
+    }
+    return areas;
+  }
+  //------------------------------------------- GET CLEARANCE AREA -------------------------------------------
+  int GameImpl::_getClearanceArea(Position position, int minClearance) const
+  {
+    const std::vector<int> &areas = this->_getClearanceAreas(minClearance);
+    if ( areas.empty() )
+      return 0;
+
+    // A unit next to a wall may be centered on a tile with less clearance, so look around it
+    int width  = this->mapWidth()*4;
+    int height = this->mapHeight()*4;
+    WalkPosition center(position);
+    for ( int r = 0; r <= minClearance; ++r )
+    {
+      for ( int y = center.y - r; y <= center.y + r; ++y )
+        for ( int x = center.x - r; x <= center.x + r; ++x )
+        {
+          if ( x < 0 || y < 0 || x >= width || y >= height )
+            continue;
+          if ( areas[y*width + x] != 0 )
+            return areas[y*width + x];
+        }
+    }
+    return 0;
+  }
+  //------------------------------------------------ HAS PATH ------------------------------------------------
+  bool GameImpl::hasPath(Position source, Position destination, UnitSizeType size) const
+  {
+    int minClearance;
+    if ( size == UnitSizeTypes::Small )
+      minClearance = 1;
+    else if ( size == UnitSizeTypes::Medium )
+      minClearance = 2;
+    else if ( size == UnitSizeTypes::Large )
+      minClearance = 3;
+    else
+      return this->hasPath(source, destination);
+
+    if ( !this->hasPath(source, destination) )
+      return false;
+
+    int sourceArea = this->_getClearanceArea(source, minClearance);
+    if ( sourceArea == 0 || sourceArea != this->_getClearanceArea(destination, minClearance) )
+      return this->setLastError(Errors::Unreachable_Location);
+    return true;
+  }
+  //--------------------------------------------- BEGIN UNIT FINDER ------------------------------------------
+  unsigned int *GameImpl::_beginUnitFinder(unsigned int &markBase)
+  {
+    // Start the generations over before they can wrap, only while no query is using its marks
+    if ( finderDepth == 0 && finderGeneration >= 0x80000000 )
+    {
+      for ( auto it = finderMarks.begin(); it != finderMarks.end(); ++it )
+        std::fill(it->begin(), it->end(), 0);
+      finderGeneration = 0;
+    }
+
+    // Nested queries (from within a callback) get their own marks
+    if ( finderDepth == (int)finderMarks.size() )
+      finderMarks.push_back(std::vector<unsigned int>(FINDER_INDEX_COUNT, 0));
+
+    markBase = finderGeneration;
+    finderGeneration += 2;
+    return finderMarks[finderDepth++].data();
+  }
+  //--------------------------------------------- END UNIT FINDER --------------------------------------------
+  void GameImpl::_endUnitFinder()
+  {
+    --finderDepth;
+  }
+  //------------------------------------------- GET GROUND DISTANCES -----------------------------------------
+  const std::vector<int> &GameImpl::_getGroundDistances(Region source) const
+  {
+    int sourceID = source->getID();
+    if ( sourceID >= (int)groundDistances.size() )
+      groundDistances.resize(sourceID + 1);
+
+    std::vector<int> &distances = groundDistances[sourceID];
+    if ( !distances.empty() )
+      return distances;
+
+    int idCount = regionNeighborOffsets.empty() ? 0 : (int)regionNeighborOffsets.size() - 1;
+    distances.assign(idCount, -1);
+    if ( sourceID >= idCount )
+      return distances;
+
+    // Dijkstra over the region graph, from center to center
+    typedef std::pair<int, Region> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > open;
+    distances[sourceID] = 0;
+    open.push(Entry(0, source));
+    while ( !open.empty() )
+    {
+      Entry current = open.top();
+      open.pop();
+      if ( current.first != distances[current.second->getID()] )
+        continue;
+
+      // The neighbors of a region are contiguous in the adjacency rows
+      int currentID = current.second->getID();
+      for ( int i = regionNeighborOffsets[currentID]; i < regionNeighborOffsets[currentID + 1]; ++i )
+      {
+        int neighborID = regionNeighbors[i];
+        Region neighbor = this->getRegion(neighborID);
+        if ( !neighbor || !neighbor->isAccessible() || neighborID >= idCount )
+          continue;
+
+        int distance = current.first + current.second->getDistance(neighbor);
+        if ( distances[neighborID] == -1 || distance < distances[neighborID] )
+        {
+          distances[neighborID] = distance;
+          open.push(Entry(distance, neighbor));
+        }
+      }
+    }
+    return distances;
+  }
+  //-------------------------------------------- GET GROUND DISTANCE -----------------------------------------
+  int GameImpl::getGroundDistance(Region source, Region destination) const
+  {
+    if ( !source || !destination )
+      return -1;
+    if ( source == destination )
+      return 0;
+    if ( source->getRegionGroupID() != destination->getRegionGroupID() )
+      return -1;
+
+    const std::vector<int> &distances = this->_getGroundDistances(source);
+    int destinationID = destination->getID();
+    if ( destinationID < 0 || destinationID >= (int)distances.size() )
+      return -1;
+    return distances[destinationID];
+  }
   //----------------------------------------------- GET FORCES -----------------------------------------------
   const Forceset& GameImpl::getForces() const
   {
@@ -80,7 +342,7 @@ namespace BWAPI
   //--------------------------------------------- CAN BUILD HERE ---------------------------------------------
   bool GameImpl::canBuildHere(TilePosition position, UnitType type, Unit builder, bool checkExplored)
   {
-    return Templates::canBuildHere(builder,position,type,checkExplored);
+    return Templates::canBuildHere(builder,position,type,checkExplored,&placementMap);
   }
   //--------------------------------------------- CAN MAKE ---------------------------------------------------
   bool GameImpl::canMake(UnitType type, Unit builder) const
@@ -112,5 +374,10 @@ namespace BWAPI
   {
     return data;
   }
+  //---------------------------------------------- STATIC GAME DATA ------------------------------------------
+  const StaticGameData* GameImpl::getStaticGameData() const
+  {
+    return staticData;
+  }
 };
 
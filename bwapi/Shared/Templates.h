@@ -29,46 +29,25 @@ namespace BWAPI
     static inline bool canUseTechUnit(Unit thisUnit, BWAPI::TechType tech, Unit targetUnit, bool checkCanTargetUnit = true, bool checkTargetsUnits = true, bool checkCanIssueCommandType = true, bool checkCommandibility = true);
     static inline bool canUseTechPosition(Unit thisUnit, BWAPI::TechType tech, Position target, bool checkTargetsPositions = true, bool checkCanIssueCommandType = true, bool checkCommandibility = true);
     //--------------------------------------------- HAS POWER ------------------------------------------------
-    const bool bPsiFieldMask[10][16] = {
-      { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
-      { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
-      { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
-      { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
-      { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 }
-    };
-    static inline bool hasPower(int x, int y, UnitType unitType, const Unitset &pylons)
+    static inline bool hasPower(int x, int y, UnitType unitType, const PowerGrid &powerGrid)
     {
       if ( unitType >= 0 && unitType < UnitTypes::None && (!unitType.requiresPsi() || !unitType.isBuilding()) )
         return true;
 
-      // Loop through all pylons for the current player
-      foreach (Unit i, pylons)
-      {
-        if ( !i->exists() || !i->isCompleted() )
-          continue;
-
-        Position p = i->getPosition();
-        if ( abs(p.x - x) >= 256 )
-          continue;
-
-        if ( abs(p.y - y) >= 160 )
-          continue;
-
-        if ( bPsiFieldMask[(y - p.y + 160) / 32][(x - p.x + 256) / 32] )
-          return true;
-      }
-      return false;
+      // The grid counts the completed pylons of the current player powering each tile
+      return powerGrid.hasPower(x, y);
     }
     //-------------------------------------------- UNIT FINDER -----------------------------------------------
     template <class finder, typename _T>
     void iterateUnitFinder(finder *finder_x, finder *finder_y, int finderCount, int left, int top, int right, int bottom, const _T &callback)
     {
-      DWORD dwFinderFlags[1701] = { 0 };
+      // Mark values unique to this query, anything at or below markBase is unmarked.
+      // The marks are never cleared between queries.
+      GameImpl *game = static_cast<GameImpl*>(BroodwarPtr);
+      unsigned int markBase;
+      unsigned int *finderMarks = game->_beginUnitFinder(markBase);
+      const unsigned int markX  = markBase + 1;
+      const unsigned int markXY = markBase + 2;
 
       // Declare some variables
       int r = right, b = bottom;
@@ -107,50 +86,51 @@ namespace BWAPI
       for ( finder *px = pLeft; px < pRight; ++px )
       {
         int iUnitIndex = px->unitIndex;
-        if ( dwFinderFlags[iUnitIndex] == 0 )
+        if ( finderMarks[iUnitIndex] <= markBase )
         {
           if ( isWidthExtended )  // If width is small, check unit bounds
           {
-            Unit u = static_cast<GameImpl*>(BroodwarPtr)->_unitFromIndex(iUnitIndex);
+            Unit u = game->_unitFromIndex(iUnitIndex);
             if ( u && u->getLeft() <= right )
-              dwFinderFlags[iUnitIndex] = 1;
+              finderMarks[iUnitIndex] = markX;
           }
           else
-            dwFinderFlags[iUnitIndex] = 1;
+            finderMarks[iUnitIndex] = markX;
         }
       }
       // Iterate the Y entries of the finder
       for ( finder *py = pTop; py < pBottom; ++py )
       {
         int iUnitIndex = py->unitIndex;
-        if ( dwFinderFlags[iUnitIndex] == 1 )
+        if ( finderMarks[iUnitIndex] == markX )
         {
           if ( isHeightExtended ) // If height is small, check unit bounds
           {
-            Unit u = static_cast<GameImpl*>(BroodwarPtr)->_unitFromIndex(iUnitIndex);
+            Unit u = game->_unitFromIndex(iUnitIndex);
             if ( u && u->getTop() <= bottom )
-              dwFinderFlags[iUnitIndex] = 2;
+              finderMarks[iUnitIndex] = markXY;
           }
           else
-            dwFinderFlags[iUnitIndex] = 2;
+            finderMarks[iUnitIndex] = markXY;
         }
       }
       // Final Iteration
       for ( finder *px = pLeft; px < pRight; ++px )
       {
         int iUnitIndex = px->unitIndex;
-        if ( dwFinderFlags[iUnitIndex] == 2 )
+        if ( finderMarks[iUnitIndex] == markXY )
         {
-          Unit u = static_cast<GameImpl*>(BroodwarPtr)->_unitFromIndex(iUnitIndex);
+          // Unmark so that duplicate entries are only reported once
+          finderMarks[iUnitIndex] = markBase;
+          Unit u = game->_unitFromIndex(iUnitIndex);
           if ( u && u->exists() )
             callback(u);
         }
-        // Reset finderFlags so it can be reused without incident
-        dwFinderFlags[iUnitIndex] = 0;
       }
+      game->_endUnitFinder();
     }
     //------------------------------------------- CAN BUILD HERE ---------------------------------------------
-    static inline bool canBuildHere(Unit builder, TilePosition position, UnitType type, bool checkExplored)
+    static inline bool canBuildHere(Unit builder, TilePosition position, UnitType type, bool checkExplored, PlacementMap *placementMap = nullptr)
     {
       Broodwar->setLastError(Errors::Unbuildable_Location);
 
@@ -185,12 +165,17 @@ namespace BWAPI
       else
         checkUnoccupied = !builder || !builder->getType().isBuilding() || ( !type.isAddon() && !type.isFlagBeacon() );
 
+      // The placement map covers the buildable, unoccupied and creep checks of the footprint
+      bool usePlacementMap = placementMap && checkUnoccupied && type != UnitTypes::Special_Start_Location;
+      if ( usePlacementMap && !placementMap->isClear(BroodwarPtr, lt, type) )
+        return false;
+
       for ( int x = lt.x; x < rb.x; ++x )
       {
         for ( int y = lt.y; y < rb.y; ++y )
         {
           // Check if tile is buildable/unoccupied and explored.
-          if ( !Broodwar->isBuildable(x, y, checkUnoccupied) || ( checkExplored && !Broodwar->isExplored(x,y)) )
+          if ( (!usePlacementMap && !Broodwar->isBuildable(x, y, checkUnoccupied)) || ( checkExplored && !Broodwar->isExplored(x,y)) )
             return false; // @TODO: Error code for !isExplored ??
         }
       }
@@ -230,28 +215,31 @@ namespace BWAPI
             return false;
         }
 
-        // Creep Check
-        if ( type.getRace() == Races::Zerg )
-        { // Creep requirement, or ignore creep if there isn't one
-          if ( type.requiresCreep() )
-          {
+        // Creep Check, already covered by the placement map when it is used
+        if ( !usePlacementMap )
+        {
+          if ( type.getRace() == Races::Zerg )
+          { // Creep requirement, or ignore creep if there isn't one
+            if ( type.requiresCreep() )
+            {
+              for ( int x = lt.x; x < rb.x; ++x )
+                for ( int y = lt.y; y < rb.y; ++y )
+                {
+                  if ( !Broodwar->hasCreep(x,y) )
+                    return false;
+                }
+            }
+          }
+          else
+          { // Can't build on the creep
             for ( int x = lt.x; x < rb.x; ++x )
               for ( int y = lt.y; y < rb.y; ++y )
               {
-                if ( !Broodwar->hasCreep(x,y) )
+                if ( Broodwar->hasCreep(x,y) )
                   return false;
               }
           }
         }
-        else
-        { // Can't build on the creep
-          for ( int x = lt.x; x < rb.x; ++x )
-            for ( int y = lt.y; y < rb.y; ++y )
-            {
-              if ( Broodwar->hasCreep(x,y) )
-                return false;
-            }
-        }
 
         // Power Check
         if ( type.requiresPsi() && !Broodwar->hasPower(lt, type) )
@@ -1681,7 +1669,7 @@ namespace BWAPI
       if (checkCanIssueCommandType && !canLand(thisUnit, checkCommandibility) )
         return false;
 
-      if ( !canBuildHere(nullptr, target, thisUnit->getType(), true) )
+      if ( !Broodwar->canBuildHere(target, thisUnit->getType(), nullptr, true) )
         return false;
 
       return true;
@@ -2542,7 +2530,7 @@ namespace BWAPI
       if (checkCanIssueCommandType && !canPlaceCOP(thisUnit, checkCommandibility) )
         return false;
 
-      if ( !canBuildHere(thisUnit, target, thisUnit->getType(), true) )
+      if ( !Broodwar->canBuildHere(target, thisUnit->getType(), thisUnit, true) )
         return false;
 
       return true;
@@ -31,16 +31,19 @@
 #include <BWAPI/Region.h>
 #include <BWAPI/Regionset.h>
 #include <BWAPI/TechType.h>
+#include <BWAPI/TileChange.h>
 #include <BWAPI/TournamentAction.h>
 #include <BWAPI/Type.h>
 #include <BWAPI/Unit.h>
 #include <BWAPI/UnitCommand.h>
 #include <BWAPI/UnitCommandType.h>
 #include <BWAPI/Unitset.h>
+#include <BWAPI/IndexedUnitset.h>
 #include <BWAPI/UnitSizeType.h>
 #include <BWAPI/UnitType.h>
 #include <BWAPI/UpgradeType.h>
 #include <BWAPI/Vectorset.h>
+#include <BWAPI/FrameArena.h>
 #include <BWAPI/WeaponType.h>
 
 namespace BWAPI
@@ -1,6 +1,9 @@
 #pragma once
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include "GameData.h"
+#include "StaticGameData.h"
 #include "GameImpl.h"
 #include "ForceImpl.h"
 #include "PlayerImpl.h"
@@ -21,12 +24,59 @@ namespace BWAPI
     void disconnect();
     void update();
 
+    // Attaches to a server as a read-only observer. Observers get every frame the server
+    // publishes without ever holding it up, and cannot issue commands or draw.
+    bool connectAsObserver();
+    bool isObserver() const;
+
+    // Sequence number of the frame that the last update() picked up
+    unsigned int getFrameSequence() const;
+
+    // Returns false if the server has started rewriting GameData since the last update(), in
+    // which case anything read since then may be torn. Always true for the controlling client.
+    bool isFrameValid() const;
+
+    // Spin on GameData::frameSequence for up to this many iterations before blocking
+    // on the server, trading a core for lower frame latency. 0 (default) always blocks.
+    void setSpinIterations(int iterations);
+    int  getSpinIterations() const;
+
+    // Number of frames that were picked up by spinning and by blocking
+    unsigned int getSpinHandoffCount() const;
+    unsigned int getBlockingHandoffCount() const;
+
     GameData  *data;
+
+    // The static map data of the current match, mapped read-only
+    const StaticGameData *staticData;
   private:
+    bool mapStaticData(int serverProcID);
+    void unmapStaticData();
+    bool startMatch();
+    void processEvents();
+    bool spinForFrame();
+    void updateObserver();
+    bool waitForServer();
+    bool claimObserverSlot();
+    void releaseObserverSlot();
+
+#ifdef _WIN32
     HANDLE    pipeObjectHandle;
     HANDLE    mapFileHandle;
+    HANDLE    staticFileHandle;
     HANDLE    gameTableFileHandle;
+    int       unreadFrameCodes; // pipe codes of frames that were picked up by spinning
+#endif
     GameTable *gameTable;
+    int       gameTableIndex;
+    int       observerSlot;
+    unsigned int lastFrameSequence;
+    unsigned int frameLockAtUpdate;
+    bool      resyncObserver;
+
+    int spinIterations;
+    unsigned int spinHandoffCount;
+    unsigned int blockingHandoffCount;
     
     bool connected;
   };
@@ -27,7 +27,11 @@ namespace BWAPIC
       SetAllies,
       SetVision,
       SetCommandOptimizerLevel,
-      SetRevealAll
+      SetRevealAll,
+      CreateDrawList,
+      BeginDrawList,
+      EndDrawList,
+      ClearDrawList
     };
   }
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace BWAPI
+{
+  // Reads a sequence number with acquire ordering, so that the GameData the other side wrote
+  // before publishing it is not read ahead of it. A plain volatile load gives no such ordering
+  // for the compiler under g++.
+  inline unsigned int loadSequence(const volatile unsigned int *seq)
+  {
+#ifdef _WIN32
+    return (unsigned int)InterlockedCompareExchange((volatile LONG*)seq, 0, 0);
+#else
+    return __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+#endif
+  }
+
+#ifndef _WIN32
+  // The POSIX transport hands frames back and forth with the GameData sequence numbers: the server
+  // increments frameSequence when a frame is ready, the client sets clientSequence to the frame it
+  // has finished. Both sides wait on the other's number with a futex, so a handoff costs a wake and
+  // no pipe round trip. The client and the stand-in server in Benchmarks share these.
+
+  // Waits until *seq no longer equals value, or the timeout expires.
+  // Returns true if the value changed.
+  inline bool waitForSequence(volatile unsigned int *seq, unsigned int value, int timeoutMs)
+  {
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while ( loadSequence(seq) == value )
+    {
+      timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      long elapsedMs = (now.tv_sec - start.tv_sec)*1000 + (now.tv_nsec - start.tv_nsec)/1000000;
+      if ( elapsedMs >= timeoutMs )
+        return false;
+#ifdef __linux__
+      long remainingMs = timeoutMs - elapsedMs;
+      timespec timeout = { remainingMs / 1000, (remainingMs % 1000) * 1000000 };
+      syscall(SYS_futex, seq, FUTEX_WAIT, value, &timeout, NULL, 0);
+#else
+      usleep(50);
+#endif
+    }
+    return true;
+  }
+  // Publishes a new value and wakes the other side if it is waiting on it
+  inline void setSequence(volatile unsigned int *seq, unsigned int value)
+  {
+    __atomic_store_n(seq, value, __ATOMIC_RELEASE);
+#ifdef __linux__
+    syscall(SYS_futex, seq, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+  }
+#endif
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstring>
+
+namespace BWAPI
+{
+  // Writes the next frame's unit, player or bullet data into its GameData slot. With delta sync
+  // the slot is only rewritten if it differs from what the client already has, in which case
+  // index is appended to the change list. Returns the number of bytes written.
+  template <class T>
+  int syncFrameSlot(T &slot, const T &next, int index, bool deltaSync, int *changed, int &changedCount)
+  {
+    if ( deltaSync )
+    {
+      if ( memcmp(&slot, &next, sizeof(T)) == 0 )
+        return 0;
+      changed[changedCount++] = index;
+    }
+    memcpy(&slot, &next, sizeof(T));
+    return sizeof(T);
+  }
+}
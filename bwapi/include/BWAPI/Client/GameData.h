@@ -9,6 +9,8 @@
 #include "Event.h"
 #include "Command.h"
 #include "Shape.h"
+#include "TileLayer.h"
+#include "StringArena.h"
 namespace BWAPIC
 {
   struct Position
@@ -32,6 +34,16 @@ namespace BWAPI
     bool isDebug;
 
     int instanceID;
+
+    //frame handoff sequence numbers, used instead of the pipe codes by the POSIX transport
+    //the server increments frameSequence when a frame is ready, the client sets clientSequence
+    //to the frame it has finished processing
+    volatile unsigned int frameSequence;
+    volatile unsigned int clientSequence;
+
+    //seqlock for read-only observers, odd while the server is writing a frame
+    volatile unsigned int frameLock;
+
     int botAPM_noselects;
     int botAPM_selects;
 
@@ -57,6 +69,19 @@ namespace BWAPI
     int nukeDotCount;
     BWAPIC::Position nukeDots[200];
 
+    // frame delta (only valid if hasFrameDelta is set)
+    // ids of the unit/player/bullet slots the server rewrote since the previous frame
+    bool hasFrameDelta;
+    int changedUnitCount;
+    int changedUnits[10000];
+    int changedPlayerCount;
+    int changedPlayers[12];
+    int changedBulletCount;
+    int changedBullets[100];
+
+    // bytes of unit/player/bullet data the server wrote this frame
+    int frameSyncBytes;
+
     int gameType;
     int latency;
     int latencyFrames;
@@ -82,34 +107,17 @@ namespace BWAPI
 
     bool flags[BWAPI::Flag::Max];
 
-    // map
+    // map, the static map data is in StaticGameData
     int mapWidth;
     int mapHeight;
-    char mapFileName[261];  //size based on broodwar memory
-    char mapPathName[261];  //size based on broodwar memory
-    char mapName[33];      //size based on broodwar memory
-    char mapHash[41];
-
-    //tile data
-    int  getGroundHeight[256][256];
-    bool isWalkable[1024][1024]; 
-    bool isBuildable[256][256];
-    bool isVisible[256][256];
-    bool isExplored[256][256];
-    bool hasCreep[256][256];
-    bool isOccupied[256][256];
-
-    unsigned short mapTileRegionId[256][256];
-    unsigned short mapSplitTilesMiniTileMask[5000];
-    unsigned short mapSplitTilesRegion1[5000];
-    unsigned short mapSplitTilesRegion2[5000];
-
-    int regionCount;
-    RegionData regions[5000];
-
-    // start locations
-    int startLocationCount;
-    BWAPIC::Position startLocations[8];
+    unsigned int staticGeneration;  //StaticGameData::generation of the current match
+
+    //tile data, the layers are row major with one bit per tile
+    TileLayer<256,256>   isVisible;
+    TileLayer<256,256>   isExplored;
+    TileLayer<256,256>   hasCreep;
+    TileLayer<256,256>   isOccupied;
+    TileChangeFeed       tileChanges;  //tiles that changed since the previous frame
 
     // match mode
     bool isInGame;
@@ -128,23 +136,25 @@ namespace BWAPI
     int neutral;
 
     static const int MAX_EVENTS         = 10000;
-    static const int MAX_EVENT_STRINGS  =  1000;
-    static const int MAX_STRINGS        = 20000;
+    // enough for as many strings of the maximum length as the old fixed slots held, pages that
+    // are never written are never touched
+    static const int MAX_EVENT_STRING_BYTES =  1000*(2 + 255 + 1);
+    static const int MAX_STRING_BYTES       = 20000*(2 + 255 + 1);
     static const int MAX_SHAPES         = 20000;
+    static const int MAX_DRAW_LISTS     =  1024;
     static const int MAX_COMMANDS       = 20000;
     static const int MAX_UNIT_COMMANDS  = 20000;
+    static const int MAX_UNIT_COMMAND_GROUP_UNITS = 40000;
 
     //events from server to client
     int eventCount;
     BWAPIC::Event events[MAX_EVENTS];
 
-    //strings used in events
-    int eventStringCount;
-    char eventStrings[MAX_EVENT_STRINGS][256];
+    //strings used in events, referred to by their offset in the arena
+    StringArena<MAX_EVENT_STRING_BYTES> eventStrings;
 
-    //strings (used in shapes and commands)
-    int stringCount;
-    char strings[MAX_STRINGS][256];
+    //strings (used in shapes and commands), referred to by their offset in the arena
+    StringArena<MAX_STRING_BYTES> strings;
 
     //shapes, commands, unitCommands, from client to server
     int shapeCount;
@@ -156,6 +166,10 @@ namespace BWAPI
     int unitCommandCount;
     BWAPIC::UnitCommand unitCommands[MAX_UNIT_COMMANDS];
 
+    //units of the group records in unitCommands
+    int unitCommandGroupUnitCount;
+    int unitCommandGroupUnits[MAX_UNIT_COMMAND_GROUP_UNITS];
+
     int unitSearchSize;
     unitFinder xUnitSearch[1700*2];
     unitFinder yUnitSearch[1700*2];
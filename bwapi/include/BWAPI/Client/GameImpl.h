@@ -1,6 +1,7 @@
 #pragma once
 #include <BWAPI.h>
 #include "GameData.h"
+#include "StaticGameData.h"
 #include "Client.h"
 #include "Shape.h"
 #include "Command.h"
@@ -10,10 +11,14 @@
 #include "RegionImpl.h"
 #include "UnitImpl.h"
 #include "BulletImpl.h"
+#include "UnitGrid.h"
+#include "PlacementMap.h"
+#include "PowerGrid.h"
 #include <list>
 #include <vector>
 
 #include <BWAPI/Unitset.h>
+#include <BWAPI/IndexedUnitset.h>
 #include <BWAPI/Bulletset.h>
 #include <BWAPI/Playerset.h>
 #include <BWAPI/Forceset.h>
@@ -35,8 +40,11 @@ namespace BWAPI
       int addCommand(const BWAPIC::Command &c);
       void processInterfaceEvents();
       void clearAll();
+      void linkUnit(UnitImpl *u);
+      void unlinkUnit(UnitImpl *u);
 
       GameData* data;
+      const StaticGameData* staticData;
       std::vector<ForceImpl>  forceVector;
       std::vector<PlayerImpl> playerVector;
       std::vector<UnitImpl>   unitVector;
@@ -45,18 +53,19 @@ namespace BWAPI
 
       Forceset forces;
       Playerset playerSet;
-      Unitset accessibleUnits;//all units that are accessible (and definitely alive)
+      IndexedUnitset accessibleUnits;//all units that are accessible (and definitely alive)
       //notDestroyedUnits - accessibleUnits = all units that may or may not be alive (status unknown)
-      Unitset minerals;
-      Unitset geysers;
-      Unitset neutralUnits;
+      IndexedUnitset minerals;
+      IndexedUnitset geysers;
+      IndexedUnitset neutralUnits;
       Unitset staticMinerals;
       Unitset staticGeysers;
       Unitset staticNeutralUnits;
       Bulletset bullets;
       Position::set nukeDots;
       Unitset selectedUnits;
-      Unitset pylons;
+      IndexedUnitset pylons;
+      PowerGrid powerGrid;
       Regionset regionsList;
 
       TilePosition::set startLocations;
@@ -70,17 +79,62 @@ namespace BWAPI
       Playerset _observers;
       mutable Error lastError;
       int textSize;
+      StringInterner textInterner;  // labels of the text shapes already in data->strings this frame
+      std::vector<std::string> drawListNames;  // indexed by handle
+      int recordingDrawList;  // list that the draw calls go to, or -1 for the current frame
+      std::vector<int> commandGroupIndices;  // units of the group being issued, keeps its storage
+      bool hasFrameBaseline;
+      UnitGrid unitGrid;
+
+      // Unit finder marks, one array per level of nested unit finder queries
+      static const int FINDER_INDEX_COUNT = 10000;
+      std::vector< std::vector<unsigned int> > finderMarks;
+      unsigned int finderGeneration;
+      int finderDepth;
+
+      // Ground distances from each source region that has been queried, indexed by region ID
+      mutable std::vector< std::vector<int> > groundDistances;
+      const std::vector<int> &_getGroundDistances(Region source) const;
+
+      // Clearance of each mini-tile in row major order, and the connected areas of mini-tiles with
+      // a clearance of at least 1, 2 and 3, labelled from 1 on first use
+      std::vector<unsigned char> clearance;
+      mutable std::vector<int> clearanceAreas[3];
+      void _computeClearance();
+      const std::vector<int> &_getClearanceAreas(int minClearance) const;
+      int _getClearanceArea(Position position, int minClearance) const;
+
+      // Region ID of each walk tile in row major order, decoded from the tile and split tile
+      // region data once at the start of the match
+      std::vector<unsigned short> walkTileRegions;
+      void _computeWalkTileRegions();
+      int _getRegionIdAt(int x, int y) const;
+
+      // Region adjacency in compressed rows, copied from the static data at the start of the match
+      std::vector<int> regionNeighborOffsets;
+      std::vector<unsigned short> regionNeighbors;
+
+      // Where the footprint of each structure size fits, refreshed from the tile change feed
+      mutable PlacementMap placementMap;
 
     public :
       Event makeEvent(BWAPIC::Event e);
       int addUnitCommand(BWAPIC::UnitCommand& c);
+      int addUnitCommandGroup(BWAPIC::UnitCommand& c, const std::vector<int> &unitIndices);
       bool inGame;
-      GameImpl(GameData* data);
+      bool readOnly;  // attached as an observer, nothing can be written to the game data
+      GameImpl(GameData* data, const StaticGameData* staticData);
       void onMatchStart();
       void onMatchEnd();
       void onMatchFrame();
+      void resyncUnits();
       const GameData* getGameData() const;
+      const StaticGameData* getStaticGameData() const;
+      // Used by the client when it has mapped the static data again for a new match
+      void setStaticGameData(const StaticGameData* staticData);
       Unit _unitFromIndex(int index);
+      unsigned int *_beginUnitFinder(unsigned int &markBase);
+      void _endUnitFinder();
 
       virtual const Forceset& getForces() const override;
       virtual const Playerset& getPlayers() const override;
@@ -118,6 +172,7 @@ namespace BWAPI
 
       virtual bool      isFlagEnabled(int flag) const override;
       virtual void      enableFlag(int flag) override;
+      virtual void      visitUnitsInRectangle(int left, int top, int right, int bottom, UnitVisitor visit, const void *context) const override;
       virtual Unitset   getUnitsInRectangle(int left, int top, int right, int bottom, const UnitFilter &pred = nullptr) const override;
       virtual Unit getClosestUnitInRectangle(Position center, const UnitFilter &pred = nullptr, int left = 0, int top = 0, int right = 999999, int bottom = 999999) const override;
       virtual Unit getBestUnit(const BestUnitFilter &best, const UnitFilter &pred, Position center = Positions::None, int radius = 999999) const override;
@@ -137,6 +192,10 @@ namespace BWAPI
       virtual bool isVisible(int x, int y) const override;
       virtual bool isExplored(int x, int y) const override;
       virtual bool hasCreep(int x, int y) const override;
+      virtual bool isAnyVisible(int left, int top, int right, int bottom) const override;
+      virtual bool isAllExplored(int left, int top, int right, int bottom) const override;
+      virtual bool hasAnyCreep(int left, int top, int right, int bottom) const override;
+      virtual bool getChangedTiles(std::vector<TilePosition> &tiles, int layers = TileChange::All) const override;
       virtual bool hasPowerPrecise(int x, int y, UnitType unitType = UnitTypes::None ) const override;
 
       virtual bool canBuildHere(TilePosition position, UnitType type, Unit builder = nullptr, bool checkExplored = false) override;
@@ -177,6 +236,11 @@ namespace BWAPI
       virtual void drawDot(CoordinateType::Enum ctype, int x, int y, Color color) override;
       virtual void drawLine(CoordinateType::Enum ctype, int x1, int y1, int x2, int y2, Color color) override;
 
+      virtual int  createDrawList(const char *name) override;
+      virtual void beginDrawList(int list) override;
+      virtual void endDrawList() override;
+      virtual void clearDrawList(int list) override;
+
       virtual int  getLatencyFrames() const override;
       virtual int  getLatencyTime() const override;
       virtual int  getRemainingLatencyFrames() const override;
@@ -192,6 +256,7 @@ namespace BWAPI
       virtual bool setMap(const char *mapFileName) override;
       virtual void setFrameSkip(int frameSkip) override;
       virtual bool hasPath(Position source, Position destination) const override;
+      virtual bool hasPath(Position source, Position destination, UnitSizeType size) const override;
       virtual bool setAlliance(BWAPI::Player player, bool allied = true, bool alliedVictory = true) override;
       virtual bool setVision(BWAPI::Player player, bool enabled = true) override;
       virtual int  elapsedTime() const override;
@@ -199,6 +264,10 @@ namespace BWAPI
       virtual int  countdownTimer() const override;
       virtual const Regionset &getAllRegions() const override;
       virtual BWAPI::Region getRegionAt(int x, int y) const override;
+      virtual int getGroundDistance(BWAPI::Region source, BWAPI::Region destination) const override;
+      virtual int getClearance(int x, int y) const override;
+      using Game::getClearance;
+      using Game::getGroundDistance;
       virtual int getLastEventTime() const override;
       virtual bool setRevealAll(bool reveal = true) override;
   };
@@ -4,21 +4,32 @@ namespace BWAPI
 {
   struct GameInstance
   {
+    static const int MAX_OBSERVERS = 4;
+
     GameInstance()
      : serverProcessID(0)
      , isConnected(false)
      , lastKeepAliveTime(0)
-    {};
+    {
+      for ( int i = 0; i < MAX_OBSERVERS; ++i )
+        observerProcessIDs[i] = 0;
+    };
     GameInstance(unsigned int servID, bool connected, unsigned int lastAliveTime)
       : serverProcessID(servID)
       , isConnected(connected)
       , lastKeepAliveTime(lastAliveTime)
-    {};
+    {
+      for ( int i = 0; i < MAX_OBSERVERS; ++i )
+        observerProcessIDs[i] = 0;
+    };
 
     unsigned int serverProcessID;
     bool isConnected;
     //time_t lastKeepAliveTime;
     unsigned int lastKeepAliveTime;
+
+    //read-only observers attached to this instance, 0 if the slot is free
+    volatile unsigned int observerProcessIDs[MAX_OBSERVERS];
   };
   struct GameTable
   {
@@ -0,0 +1,200 @@
+#pragma once
+#include <BWAPI.h>
+#include "TileLayer.h"
+#include <vector>
+
+namespace BWAPI
+{
+  // Caches where the footprint of a structure fits, considering only the tiles under it: each
+  // tile must be buildable and unoccupied, and have creep or not depending on the structure.
+  // Every footprint size and creep rule gets its own bitmap, built the first time it is needed.
+  // Tiles are refreshed when the tile change feed reports a change to their visibility, creep or
+  // occupation, and only the footprint positions covering a tile whose state actually changed
+  // are recomputed. If a feed was missed, every tile is refreshed.
+  class PlacementMap
+  {
+    public:
+      PlacementMap() : width(0), height(0), lastSequence(0) {}
+
+      // Forgets all cached state, called at the start of a match
+      void reset(int mapWidth, int mapHeight)
+      {
+        width  = mapWidth;
+        height = mapHeight;
+        tileState.clear();
+        dirtyTiles.clear();
+        dirtyMarks.assign(width*height, 0);
+        footprints.clear();
+      }
+      // Schedules the tiles in a change feed for a refresh
+      void invalidate(const TileChangeFeed &changes)
+      {
+        // The same feed was already applied
+        if ( changes.sequence == lastSequence && !tileState.empty() )
+          return;
+        bool missedFeed = changes.sequence != lastSequence + 1;
+        lastSequence = changes.sequence;
+
+        // Nothing has been cached yet
+        if ( tileState.empty() )
+          return;
+
+        if ( missedFeed )
+        {
+          for ( int y = 0; y < height; ++y )
+            for ( int x = 0; x < width; ++x )
+              invalidateTile(x, y);
+          return;
+        }
+
+        if ( changes.tileCount != -1 )
+        {
+          for ( int i = 0; i < changes.tileCount; ++i )
+          {
+            if ( changes.tiles[i].layers & (TileChange::Visible | TileChange::Creep | TileChange::Occupied) )
+              invalidateTile(changes.tiles[i].x, changes.tiles[i].y);
+          }
+          return;
+        }
+
+        for ( int by = 0; by*TileChangeFeed::BLOCK_SIZE < height; ++by )
+          for ( int bx = 0; bx*TileChangeFeed::BLOCK_SIZE < width; ++bx )
+          {
+            if ( !changes.blocks.get(bx, by) )
+              continue;
+            for ( int y = by*TileChangeFeed::BLOCK_SIZE; y < (by + 1)*TileChangeFeed::BLOCK_SIZE && y < height; ++y )
+              for ( int x = bx*TileChangeFeed::BLOCK_SIZE; x < (bx + 1)*TileChangeFeed::BLOCK_SIZE && x < width; ++x )
+                invalidateTile(x, y);
+          }
+      }
+      // Checks the tiles under a structure of the given type placed with its top left corner at
+      // position. Only applies to structures that need unoccupied tiles.
+      bool isClear(const Game *game, TilePosition position, UnitType type)
+      {
+        TilePosition size = type.tileSize();
+        if ( position.x < 0 || position.y < 0 || position.x + size.x > width || position.y + size.y > height )
+          return false;
+
+        refresh(game);
+        const Footprint &f = getFootprint(size.x, size.y, creepRule(type));
+        return f.clear[position.y*width + position.x] != 0;
+      }
+    private:
+      enum CreepRule
+      {
+        NoCreep,
+        RequiresCreep,
+        IgnoresCreep
+      };
+      enum TileFlags
+      {
+        Buildable = 1,  // buildable and not occupied
+        Creep     = 2
+      };
+      struct Footprint
+      {
+        int width;
+        int height;
+        CreepRule rule;
+        std::vector<unsigned char> clear;  // indexed by the top left tile
+      };
+
+      static CreepRule creepRule(UnitType type)
+      {
+        if ( type.getRace() != Races::Zerg )
+          return NoCreep;
+        return type.requiresCreep() ? RequiresCreep : IgnoresCreep;
+      }
+      static unsigned char getTileState(const Game *game, int x, int y)
+      {
+        return (game->isBuildable(x, y, true) ? Buildable : 0) | (game->hasCreep(x, y) ? Creep : 0);
+      }
+      void invalidateTile(int x, int y)
+      {
+        int i = y*width + x;
+        if ( x >= width || y >= height || dirtyMarks[i] )
+          return;
+        dirtyMarks[i] = 1;
+        dirtyTiles.push_back(i);
+      }
+      // Brings the tile states and footprints up to date with the scheduled tiles
+      void refresh(const Game *game)
+      {
+        if ( tileState.empty() )
+        {
+          tileState.resize(width*height);
+          for ( int y = 0; y < height; ++y )
+            for ( int x = 0; x < width; ++x )
+              tileState[y*width + x] = getTileState(game, x, y);
+          return;
+        }
+
+        for ( auto it = dirtyTiles.begin(); it != dirtyTiles.end(); ++it )
+        {
+          int x = *it % width, y = *it / width;
+          dirtyMarks[*it] = 0;
+
+          unsigned char state = getTileState(game, x, y);
+          if ( state == tileState[*it] )
+            continue;
+          tileState[*it] = state;
+
+          // Recompute every placement of every footprint that covers this tile
+          for ( auto f = footprints.begin(); f != footprints.end(); ++f )
+          {
+            for ( int fy = y - f->height + 1; fy <= y; ++fy )
+              for ( int fx = x - f->width + 1; fx <= x; ++fx )
+              {
+                if ( fx >= 0 && fy >= 0 )
+                  f->clear[fy*width + fx] = computeClear(*f, fx, fy);
+              }
+          }
+        }
+        dirtyTiles.clear();
+      }
+      const Footprint &getFootprint(int w, int h, CreepRule rule)
+      {
+        for ( auto f = footprints.begin(); f != footprints.end(); ++f )
+        {
+          if ( f->width == w && f->height == h && f->rule == rule )
+            return *f;
+        }
+
+        footprints.push_back(Footprint());
+        Footprint &f = footprints.back();
+        f.width  = w;
+        f.height = h;
+        f.rule   = rule;
+        f.clear.resize(width*height);
+        for ( int y = 0; y < height; ++y )
+          for ( int x = 0; x < width; ++x )
+            f.clear[y*width + x] = computeClear(f, x, y);
+        return f;
+      }
+      unsigned char computeClear(const Footprint &f, int x, int y) const
+      {
+        if ( x + f.width > width || y + f.height > height )
+          return 0;
+        for ( int ty = y; ty < y + f.height; ++ty )
+          for ( int tx = x; tx < x + f.width; ++tx )
+          {
+            unsigned char state = tileState[ty*width + tx];
+            if ( !(state & Buildable) )
+              return 0;
+            if ( f.rule == NoCreep && (state & Creep) )
+              return 0;
+            if ( f.rule == RequiresCreep && !(state & Creep) )
+              return 0;
+          }
+        return 1;
+      }
+
+      int width;
+      int height;
+      unsigned int lastSequence;  // of the last feed passed to invalidate
+      std::vector<unsigned char> tileState;
+      std::vector<int> dirtyTiles;
+      std::vector<unsigned char> dirtyMarks;
+      std::vector<Footprint> footprints;
+  };
+}
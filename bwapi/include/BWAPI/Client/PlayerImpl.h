@@ -4,6 +4,7 @@
 #include <string>
 
 #include <BWAPI/Unitset.h>
+#include <BWAPI/IndexedUnitset.h>
 
 namespace BWAPI
 {
@@ -16,7 +17,7 @@ namespace BWAPI
       int id;
     public:
       PlayerData* self;
-      Unitset units;
+      IndexedUnitset units;
       void clear();
       PlayerImpl(int id);
       virtual int getID() const override;
@@ -0,0 +1,178 @@
+#pragma once
+#include <BWAPI.h>
+#include <vector>
+
+namespace BWAPI
+{
+  // Counts how many completed pylons power each tile, so that a power query is a single lookup
+  // instead of a scan of every pylon. Pylons are added when they are discovered and removed
+  // when they are evaded. A pylon that is still under construction is kept aside and added to
+  // the grid on the frame it completes.
+  class PowerGrid
+  {
+    public:
+      PowerGrid() : width(0), height(0) {}
+
+      // Forgets all pylons, called at the start of a match
+      void reset(int mapWidth, int mapHeight)
+      {
+        width  = mapWidth;
+        height = mapHeight;
+        clear();
+      }
+      // Forgets all pylons but keeps the map size
+      void clear()
+      {
+        coverage.assign(width*height, 0);
+        leftEdge.assign(width*height, 0);
+        topEdge.assign(width*height, 0);
+        poweringPylons.clear();
+        pendingPylons.clear();
+      }
+      void addPylon(Unit pylon)
+      {
+        if ( contains(poweringPylons, pylon) || contains(pendingPylons, pylon) )
+          return;
+        if ( pylon->exists() && pylon->isCompleted() )
+          applyPylon(pylon);
+        else
+          pendingPylons.push_back(pylon);
+      }
+      void removePylon(Unit pylon)
+      {
+        for ( size_t i = 0; i < poweringPylons.size(); ++i )
+        {
+          if ( poweringPylons[i].unit == pylon )
+          {
+            applyField(poweringPylons[i].position, -1);
+            poweringPylons[i] = poweringPylons.back();
+            poweringPylons.pop_back();
+            return;
+          }
+        }
+        for ( size_t i = 0; i < pendingPylons.size(); ++i )
+        {
+          if ( pendingPylons[i] == pylon )
+          {
+            pendingPylons[i] = pendingPylons.back();
+            pendingPylons.pop_back();
+            return;
+          }
+        }
+      }
+      // Adds the pylons that completed this frame, called once per frame
+      void update()
+      {
+        for ( size_t i = 0; i < pendingPylons.size(); )
+        {
+          Unit pylon = pendingPylons[i];
+          if ( pylon->exists() && pylon->isCompleted() )
+          {
+            pendingPylons[i] = pendingPylons.back();
+            pendingPylons.pop_back();
+            applyPylon(pylon);
+          }
+          else
+            ++i;
+        }
+      }
+      // Checks if the given pixel is powered. Gives the same result as testing the psi field of
+      // every completed pylon, for any pixel on the map.
+      bool hasPower(int x, int y) const
+      {
+        if ( x < 0 || y < 0 || x >= width*32 || y >= height*32 )
+          return false;
+
+        // A pylon's field excludes pixels exactly 256 to its left or 160 above it, which are
+        // the first pixel column of its leftmost tiles and the first pixel row of its top tiles.
+        int i = (y/32)*width + x/32;
+        int count = coverage[i];
+        if ( x % 32 == 0 )
+          count -= leftEdge[i];
+        if ( y % 32 == 0 )
+          count -= topEdge[i];
+        return count > 0;
+      }
+    private:
+      // The tiles powered by a pylon, relative to the tile 8 columns left of and 5 rows above its
+      // center. Pylons sit on tile boundaries, so the field lines up with the tiles.
+      static bool inPsiField(int row, int col)
+      {
+        static const bool psiFieldMask[10][16] = {
+          { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+          { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+          { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
+          { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+          { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+          { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+          { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+          { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
+          { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+          { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 }
+        };
+        return psiFieldMask[row][col];
+      }
+
+      struct PoweringPylon
+      {
+        Unit unit;
+        Position position;
+      };
+
+      static bool contains(const std::vector<PoweringPylon> &list, Unit pylon)
+      {
+        for ( auto it = list.begin(); it != list.end(); ++it )
+        {
+          if ( it->unit == pylon )
+            return true;
+        }
+        return false;
+      }
+      static bool contains(const std::vector<Unit> &list, Unit pylon)
+      {
+        for ( auto it = list.begin(); it != list.end(); ++it )
+        {
+          if ( *it == pylon )
+            return true;
+        }
+        return false;
+      }
+      void applyPylon(Unit pylon)
+      {
+        PoweringPylon p = { pylon, pylon->getPosition() };
+        poweringPylons.push_back(p);
+        applyField(p.position, 1);
+      }
+      // Adds delta to every tile in the psi field of a pylon at the given position
+      void applyField(Position position, int delta)
+      {
+        int left = position.x/32 - 8, top = position.y/32 - 5;
+        for ( int row = 0; row < 10; ++row )
+        {
+          int y = top + row;
+          if ( y < 0 || y >= height )
+            continue;
+          for ( int col = 0; col < 16; ++col )
+          {
+            int x = left + col;
+            if ( x < 0 || x >= width || !inPsiField(row, col) )
+              continue;
+            int i = y*width + x;
+            coverage[i] += delta;
+            if ( col == 0 )
+              leftEdge[i] += delta;
+            if ( row == 0 )
+              topEdge[i] += delta;
+          }
+        }
+      }
+
+      int width;
+      int height;
+      std::vector<short> coverage;  // number of pylons powering each tile
+      std::vector<short> leftEdge;  // pylons that power the tile through their leftmost column
+      std::vector<short> topEdge;   // pylons that power the tile through their top row
+      std::vector<PoweringPylon> poweringPylons;
+      std::vector<Unit> pendingPylons;
+  };
+}
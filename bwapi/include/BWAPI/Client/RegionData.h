@@ -16,9 +16,7 @@ namespace BWAPI
     int   topMost;
     int   bottomMost;
 
-    int   neighborCount;
-    int   neighbors[256];
-
+    // the neighbors are in StaticGameData::regionNeighbors
     bool  isAccessible;
     bool  isHigherGround;
   };
@@ -10,7 +10,7 @@ namespace BWAPI
   class RegionImpl : public RegionInterface
   {
   private:
-    RegionData *self;
+    const RegionData *self;
     Regionset neighbors;
     BWAPI::Region closestAccessibleRgn;
     BWAPI::Region closestInaccessibleRgn;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "RegionData.h"
+#include "TileLayer.h"
+#include "GameData.h"
+
+namespace BWAPI
+{
+  // The data that does not change during a match. The server writes it once at the start of each
+  // match into a shared section of its own, which clients map read-only, so the per-frame GameData
+  // only holds what changes between frames.
+  struct StaticGameData
+  {
+    //revision stays at the top of struct so it doesn't move in memory from revision to revision.
+    int revision;
+
+    //incremented every time the server rewrites the section, GameData::staticGeneration holds the
+    //generation that belongs to the current match
+    volatile unsigned int generation;
+
+    // map
+    char mapFileName[261];  //size based on broodwar memory
+    char mapPathName[261];  //size based on broodwar memory
+    char mapName[33];      //size based on broodwar memory
+    char mapHash[41];
+
+    //tile data, the layers are row major with one bit per tile
+    int  getGroundHeight[256][256];
+    TileLayer<1024,1024> isWalkable;
+    TileLayer<256,256>   isBuildable;
+
+    unsigned short mapTileRegionId[256][256];
+    unsigned short mapSplitTilesMiniTileMask[5000];
+    unsigned short mapSplitTilesRegion1[5000];
+    unsigned short mapSplitTilesRegion2[5000];
+
+    int regionCount;
+    RegionData regions[5000];
+
+    //region adjacency, the neighbors of region i are the IDs in regionNeighbors from
+    //regionNeighborOffsets[i] up to regionNeighborOffsets[i+1]. The region graph is planar, so
+    //there are fewer than 6 neighbors per region on average.
+    static const int MAX_REGION_NEIGHBORS = 30000;
+    int regionNeighborOffsets[5001];
+    unsigned short regionNeighbors[MAX_REGION_NEIGHBORS];
+
+    // start locations
+    int startLocationCount;
+    BWAPIC::Position startLocations[8];
+  };
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <cstring>
+#include <vector>
+
+namespace BWAPI
+{
+  // Strings packed one after the other, so that a frame only touches as many bytes as its strings
+  // actually use. Each string is stored as its length in two bytes, its characters and a null, and
+  // is referred to by the offset of its first character. The writer adds strings during a frame
+  // and the server empties the arena for the next one.
+  // It has no constructor so that it can live in the shared memory GameData.
+  template <int SIZE>
+  struct StringArena
+  {
+    static const int MAX_LENGTH = 255;  // longer strings are cut, as in the old 256 byte slots
+
+    int  size;
+    char data[SIZE];
+
+    void clear()
+    {
+      size = 0;
+    }
+    // The size is written by another process, never trust it to be within the arena
+    int used() const
+    {
+      if ( size < 0 )
+        return 0;
+      return size > SIZE ? SIZE : size;
+    }
+    // Copies a string into the arena and returns its handle, or -1 if the arena is full
+    int add(const char *text)
+    {
+      int length = 0;
+      while ( length < MAX_LENGTH && text[length] )
+        ++length;
+      return add(text, length);
+    }
+    int add(const char *text, int length)
+    {
+      int start = used();
+      if ( start + 2 + length + 1 > SIZE )
+        return -1;
+      data[start]     = (char)(length & 0xFF);
+      data[start + 1] = (char)(length >> 8);
+
+      int handle = start + 2;
+      memcpy(&data[handle], text, length);
+      data[handle + length] = 0;
+      size = handle + length + 1;
+      return handle;
+    }
+    // The handle and the contents may come from another process. A handle outside of the arena,
+    // or a string that is not terminated within it, gives an empty string.
+    const char *get(int handle) const
+    {
+      if ( handle < 2 || handle >= used() || !memchr(&data[handle], 0, used() - handle) )
+        return "";
+      return &data[handle];
+    }
+    // Gives 0 for a handle outside of the arena, or whose length would end past it
+    int length(int handle) const
+    {
+      if ( handle < 2 || handle >= used() )
+        return 0;
+      int length = (unsigned char)data[handle - 2] | ((unsigned char)data[handle - 1] << 8);
+      return handle + length < used() ? length : 0;
+    }
+  };
+
+  // Remembers the strings a writer has added to an arena during the current frame, so that a label
+  // drawn many times is only stored once. Lives in the writer's process; it notices that the
+  // server has emptied the arena when its size no longer matches the size after the last add.
+  // Another writer may share the arena, so a remembered handle is only used after checking that
+  // the arena still holds the same string there.
+  class StringInterner
+  {
+    public:
+      StringInterner() : arenaSize(0), count(0) {}
+
+      template <int SIZE>
+      int add(StringArena<SIZE> &arena, const char *text)
+      {
+        if ( arena.size != arenaSize )
+          clear();
+
+        // Measure and hash the string in one pass, labels are read often enough for it to show
+        int length = 0;
+        unsigned int hash = FNV_OFFSET;
+        while ( length < StringArena<SIZE>::MAX_LENGTH && text[length] )
+          hash = (hash ^ (unsigned char)text[length++]) * FNV_PRIME;
+
+        if ( table.empty() )
+          table.assign(INITIAL_SLOTS, -1);
+        for ( size_t i = hash & (table.size() - 1); ; i = (i + 1) & (table.size() - 1) )
+        {
+          int handle = table[i];
+          if ( handle == -1 )
+          {
+            handle = arena.add(text, length);
+            arenaSize = arena.size;
+            if ( handle != -1 )
+            {
+              table[i] = handle;
+              if ( ++count * 2 > (int)table.size() )
+                grow(arena);
+            }
+            return handle;
+          }
+          if ( holds(arena, handle, text, length) )
+            return handle;
+        }
+      }
+      // Forgets all strings, the arena has been emptied
+      void clear()
+      {
+        if ( count > 0 )
+          table.assign(table.size(), -1);
+        count     = 0;
+        arenaSize = 0;
+      }
+    private:
+      static const int INITIAL_SLOTS = 1024;
+      static const unsigned int FNV_OFFSET = 2166136261u;
+      static const unsigned int FNV_PRIME  = 16777619u;
+
+      static unsigned int hashString(const char *text, int length)
+      {
+        unsigned int hash = FNV_OFFSET;
+        for ( int i = 0; i < length; ++i )
+          hash = (hash ^ (unsigned char)text[i]) * FNV_PRIME;
+        return hash;
+      }
+      template <int SIZE>
+      static bool holds(const StringArena<SIZE> &arena, int handle, const char *text, int length)
+      {
+        return handle + length < arena.used() &&
+               arena.length(handle) == length &&
+               arena.data[handle + length] == 0 &&
+               memcmp(&arena.data[handle], text, length) == 0;
+      }
+      template <int SIZE>
+      void grow(const StringArena<SIZE> &arena)
+      {
+        std::vector<int> old(table.size() * 2, -1);
+        old.swap(table);
+        count = 0;
+        for ( auto it = old.begin(); it != old.end(); ++it )
+        {
+          if ( *it == -1 || *it < 2 || *it >= arena.used() )
+            continue;
+          size_t i = hashString(&arena.data[*it], arena.length(*it)) & (table.size() - 1);
+          while ( table[i] != -1 )
+            i = (i + 1) & (table.size() - 1);
+          table[i] = *it;
+          ++count;
+        }
+      }
+
+      int arenaSize;
+      int count;
+      std::vector<int> table;  // open addressing, handles of the strings or -1 for an empty slot
+  };
+}
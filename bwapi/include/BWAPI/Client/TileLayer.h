@@ -0,0 +1,217 @@
+#pragma once
+#include <cstring>
+#include <vector>
+#include <BWAPI/Position.h>
+#include <BWAPI/TileChange.h>
+
+namespace BWAPI
+{
+  // A map layer that stores one bit per tile. Rows are stored one after the other in 64 bit
+  // words, so a row of the map is contiguous and a rectangle can be tested a word at a time.
+  // It has no constructor so that it can live in the shared memory GameData.
+  template <int WIDTH, int HEIGHT>
+  struct TileLayer
+  {
+    typedef unsigned long long Word;
+    static const int WORD_BITS     = 64;
+    static const int WORDS_PER_ROW = (WIDTH + WORD_BITS - 1) / WORD_BITS;
+
+    Word rows[HEIGHT][WORDS_PER_ROW];
+
+    // The coordinates must be within the layer
+    bool get(int x, int y) const
+    {
+      return ((rows[y][x / WORD_BITS] >> (x % WORD_BITS)) & 1) != 0;
+    }
+    void set(int x, int y, bool value)
+    {
+      Word bit = (Word)1 << (x % WORD_BITS);
+      if ( value )
+        rows[y][x / WORD_BITS] |= bit;
+      else
+        rows[y][x / WORD_BITS] &= ~bit;
+    }
+    void clear()
+    {
+      memset(rows, 0, sizeof(rows));
+    }
+
+    // Checks if any tile is set in the rectangle. The bounds are inclusive and must be within
+    // the layer.
+    bool anyInRect(int left, int top, int right, int bottom) const
+    {
+      int firstWord = left / WORD_BITS;
+      int lastWord  = right / WORD_BITS;
+      Word firstMask = ~(Word)0 << (left % WORD_BITS);
+      Word lastMask  = ~(Word)0 >> (WORD_BITS - 1 - right % WORD_BITS);
+      if ( firstWord == lastWord )
+        firstMask &= lastMask;
+
+      for ( int y = top; y <= bottom; ++y )
+      {
+        const Word *row = rows[y];
+        if ( row[firstWord] & firstMask )
+          return true;
+        if ( firstWord == lastWord )
+          continue;
+        for ( int w = firstWord + 1; w < lastWord; ++w )
+        {
+          if ( row[w] )
+            return true;
+        }
+        if ( row[lastWord] & lastMask )
+          return true;
+      }
+      return false;
+    }
+    // Checks if every tile is set in the rectangle. The bounds are inclusive and must be within
+    // the layer.
+    bool allInRect(int left, int top, int right, int bottom) const
+    {
+      int firstWord = left / WORD_BITS;
+      int lastWord  = right / WORD_BITS;
+      Word firstMask = ~(Word)0 << (left % WORD_BITS);
+      Word lastMask  = ~(Word)0 >> (WORD_BITS - 1 - right % WORD_BITS);
+      if ( firstWord == lastWord )
+        firstMask &= lastMask;
+
+      for ( int y = top; y <= bottom; ++y )
+      {
+        const Word *row = rows[y];
+        if ( (row[firstWord] & firstMask) != firstMask )
+          return false;
+        if ( firstWord == lastWord )
+          continue;
+        for ( int w = firstWord + 1; w < lastWord; ++w )
+        {
+          if ( row[w] != ~(Word)0 )
+            return false;
+        }
+        if ( (row[lastWord] & lastMask) != lastMask )
+          return false;
+      }
+      return true;
+    }
+  };
+
+  // A tile that changed since the previous frame, layers is a combination of TileChange::Enum
+  struct ChangedTile
+  {
+    unsigned char x;
+    unsigned char y;
+    unsigned char layers;
+  };
+
+  // The tiles whose visibility, exploration, creep or occupation changed since the previous
+  // frame. When more tiles change than fit in the list, the feed marks the 8x8 blocks that
+  // contain changes instead. Like TileLayer it has no constructor so that it can live in GameData.
+  // The sequence number goes up by one every frame, so a reader that did not see the previous
+  // feed knows that it missed changes and has to check every tile again.
+  struct TileChangeFeed
+  {
+    typedef TileLayer<256,256>::Word Word;
+    static const int MAX_TILES  = 4096;
+    static const int BLOCK_SIZE = 8;
+
+    unsigned int sequence;
+    int tileCount;  // -1 if the list overflowed and blocks is used instead
+    ChangedTile tiles[MAX_TILES];
+    TileLayer<256/BLOCK_SIZE, 256/BLOCK_SIZE> blocks;
+
+    // Starts the feed of the next frame
+    void clear()
+    {
+      ++sequence;
+      tileCount = 0;
+    }
+    // Marks the whole map as changed, used when there is no previous frame to compare with
+    void markAll()
+    {
+      tileCount = -1;
+      memset(blocks.rows, 0xFF, sizeof(blocks.rows));
+    }
+    // Adds the changes in one word of a row. Each parameter has a bit set for every tile whose
+    // layer changed.
+    void addWord(int y, int wordIndex, Word visible, Word explored, Word creep, Word occupied)
+    {
+      Word changed = visible | explored | creep | occupied;
+      if ( !changed )
+        return;
+
+      int x = wordIndex*TileLayer<256,256>::WORD_BITS;
+      for ( Word bits = changed; bits != 0 && tileCount != -1; bits >>= 1, ++x )
+      {
+        if ( !(bits & 1) )
+          continue;
+        if ( tileCount == MAX_TILES )
+        {
+          overflow();
+          break;
+        }
+        Word bit = (Word)1 << (x % TileLayer<256,256>::WORD_BITS);
+        ChangedTile &t = tiles[tileCount++];
+        t.x      = (unsigned char)x;
+        t.y      = (unsigned char)y;
+        t.layers = (unsigned char)( (visible  & bit ? TileChange::Visible  : 0) |
+                                    (explored & bit ? TileChange::Explored : 0) |
+                                    (creep    & bit ? TileChange::Creep    : 0) |
+                                    (occupied & bit ? TileChange::Occupied : 0) );
+      }
+      if ( tileCount != -1 )
+        return;
+
+      // Mark the blocks covered by each byte of the word
+      for ( int b = 0; b < TileLayer<256,256>::WORD_BITS/BLOCK_SIZE; ++b )
+      {
+        if ( (changed >> (b*BLOCK_SIZE)) & 0xFF )
+          blocks.set(wordIndex*TileLayer<256,256>::WORD_BITS/BLOCK_SIZE + b, y/BLOCK_SIZE, true);
+      }
+    }
+    // Copies only the part of the feed that is in use
+    void copyTo(TileChangeFeed &other) const
+    {
+      other.sequence  = sequence;
+      other.tileCount = tileCount;
+      if ( tileCount == -1 )
+        memcpy(other.blocks.rows, blocks.rows, sizeof(blocks.rows));
+      else
+        memcpy(other.tiles, tiles, tileCount*sizeof(ChangedTile));
+    }
+    // Appends the changed tiles of the given layers to out. Returns false if the list overflowed,
+    // in which case every tile of the changed blocks is appended.
+    bool getTiles(int layers, int mapWidth, int mapHeight, std::vector<TilePosition> &out) const
+    {
+      if ( tileCount != -1 )
+      {
+        for ( int i = 0; i < tileCount; ++i )
+        {
+          if ( tiles[i].layers & layers )
+            out.push_back(TilePosition(tiles[i].x, tiles[i].y));
+        }
+        return true;
+      }
+
+      for ( int by = 0; by*BLOCK_SIZE < mapHeight; ++by )
+      {
+        for ( int bx = 0; bx*BLOCK_SIZE < mapWidth; ++bx )
+        {
+          if ( !blocks.get(bx, by) )
+            continue;
+          for ( int y = by*BLOCK_SIZE; y < (by + 1)*BLOCK_SIZE && y < mapHeight; ++y )
+            for ( int x = bx*BLOCK_SIZE; x < (bx + 1)*BLOCK_SIZE && x < mapWidth; ++x )
+              out.push_back(TilePosition(x, y));
+        }
+      }
+      return false;
+    }
+  private:
+    // Switches from the list to blocks, keeping the changes that were listed so far
+    void overflow()
+    {
+      blocks.clear();
+      for ( int i = 0; i < tileCount; ++i )
+        blocks.set(tiles[i].x/BLOCK_SIZE, tiles[i].y/BLOCK_SIZE, true);
+      tileCount = -1;
+    }
+  };
+}
@@ -11,10 +11,16 @@ namespace BWAPIC
   struct UnitCommand
   {
     BWAPI::UnitCommandType type;
-    int unitIndex;
+    int unitIndex;    // index of the unit, or of a group of units (see isGroup)
     int targetIndex;
     int x;
     int y;
     int extra;
+
+    // A group record gives the command to several units. Its units are listed in
+    // GameData::unitCommandGroupUnits, as a count followed by the unit indices.
+    bool isGroup() const      { return unitIndex < -1; }
+    int  groupStart() const   { return -2 - unitIndex; }
+    void setGroup(int start)  { unitIndex = -2 - start; }
   };
 }
\ No newline at end of file
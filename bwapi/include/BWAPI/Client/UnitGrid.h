@@ -0,0 +1,136 @@
+#pragma once
+#include <BWAPI.h>
+#include <vector>
+
+namespace BWAPI
+{
+  // Buckets units into fixed size cells by their position. It is rebuilt once per frame so that
+  // rectangle queries only need to look at the cells around the rectangle.
+  class UnitGrid
+  {
+    public:
+      static const int CELL_SIZE = 128; // in pixels
+
+      UnitGrid() : columns(0), rows(0), reachX(0), reachY(0), valid(false) {}
+
+      // Marks the grid as out of date, queries must use the unit finder until the next rebuild
+      void invalidate()
+      {
+        valid = false;
+      }
+      bool isValid() const
+      {
+        return valid;
+      }
+      void rebuild(const Unitset &units, int width, int height)
+      {
+        columns = (width  + CELL_SIZE - 1) / CELL_SIZE;
+        rows    = (height + CELL_SIZE - 1) / CELL_SIZE;
+        valid   = columns > 0 && rows > 0;
+        if ( !valid )
+          return;
+
+        // Count the units in each cell. The vectors keep their capacity, so there are no allocations
+        // after the first few frames.
+        cellStart.assign(columns*rows + 1, 0);
+        unitCells.clear();
+        reachX = reachY = 0;
+        for ( auto u = units.begin(); u != units.end(); ++u )
+        {
+          // Loaded units are not part of the unit finder either
+          int cell = -1;
+          if ( !(*u)->isLoaded() && (*u)->getPosition().isValid() )
+          {
+            cell = cellIndex((*u)->getPosition().x, (*u)->getPosition().y);
+            ++cellStart[cell + 1];
+
+            UnitType type = (*u)->getType();
+            if ( type.dimensionLeft() > reachX )  reachX = type.dimensionLeft();
+            if ( type.dimensionRight() > reachX ) reachX = type.dimensionRight();
+            if ( type.dimensionUp() > reachY )    reachY = type.dimensionUp();
+            if ( type.dimensionDown() > reachY )  reachY = type.dimensionDown();
+          }
+          unitCells.push_back(cell);
+        }
+
+        // Turn the counts into offsets and place the units
+        for ( int c = 0; c < columns*rows; ++c )
+          cellStart[c + 1] += cellStart[c];
+        cellUnits.resize(cellStart[columns*rows]);
+        cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+
+        // The bounds are stored with the unit, so that queries don't have to look them up
+        int i = 0;
+        for ( auto u = units.begin(); u != units.end(); ++u, ++i )
+        {
+          if ( unitCells[i] == -1 )
+            continue;
+          Entry &e = cellUnits[cellFill[unitCells[i]]++];
+          e.unit   = *u;
+          e.left   = (*u)->getLeft();
+          e.top    = (*u)->getTop();
+          e.right  = (*u)->getRight();
+          e.bottom = (*u)->getBottom();
+        }
+      }
+      // Calls callback for every existing unit that has any part of it within the rectangle
+      template <typename F>
+      void iterateRectangle(int left, int top, int right, int bottom, const F &callback) const
+      {
+        if ( left > right || top > bottom )
+          return;
+
+        // Units are bucketed by their center, so their bounds can reach into neighbouring cells, but
+        // no farther than the largest unit in the grid reaches
+        int cLeft   = clampColumn( (left   - reachX) / CELL_SIZE );
+        int cRight  = clampColumn( (right  + reachX) / CELL_SIZE );
+        int cTop    = clampRow(    (top    - reachY) / CELL_SIZE );
+        int cBottom = clampRow(    (bottom + reachY) / CELL_SIZE );
+
+        for ( int y = cTop; y <= cBottom; ++y )
+        {
+          for ( int x = cLeft; x <= cRight; ++x )
+          {
+            int cell = y*columns + x;
+            for ( int i = cellStart[cell]; i < cellStart[cell + 1]; ++i )
+            {
+              const Entry &e = cellUnits[i];
+              if ( e.left <= right && e.right >= left &&
+                   e.top <= bottom && e.bottom >= top &&
+                   e.unit->exists() )
+                callback(e.unit);
+            }
+          }
+        }
+      }
+    private:
+      int clampColumn(int x) const
+      {
+        return x < 0 ? 0 : (x >= columns ? columns - 1 : x);
+      }
+      int clampRow(int y) const
+      {
+        return y < 0 ? 0 : (y >= rows ? rows - 1 : y);
+      }
+      int cellIndex(int x, int y) const
+      {
+        return clampRow(y / CELL_SIZE)*columns + clampColumn(x / CELL_SIZE);
+      }
+
+      struct Entry
+      {
+        Unit unit;
+        int left, top, right, bottom;
+      };
+
+      int columns;
+      int rows;
+      int reachX;   // farthest any unit in the grid reaches from its position, in pixels
+      int reachY;
+      bool valid;
+      std::vector<int>   cellStart;  // offset of each cell in cellUnits, plus the end offset
+      std::vector<int>   cellFill;
+      std::vector<int>   unitCells;  // cell of each unit passed to rebuild, -1 if it was left out
+      std::vector<Entry> cellUnits;
+  };
+}
@@ -22,6 +22,8 @@ namespace BWAPI
       UnitData* self;
       Unitset   connectedUnits;
       Unitset   loadedUnits;
+      Unit      connectedTo;  // unit whose connectedUnits contains this unit
+      Unit      loadedInto;   // unit whose loadedUnits contains this unit
       void      clear();
       void      saveInitialState();
 
@@ -238,5 +240,10 @@ namespace BWAPI
       virtual bool canIssueCommandGrouped(UnitCommand command, bool checkCanUseTechPositionOnPositions = true, bool checkCanUseTechUnitOnUnits = true, bool checkCanTargetUnit = true, bool checkCanIssueCommandType = true, bool checkCommandibilityGrouped = true, bool checkCommandibility = true) const override;
 
       virtual bool issueCommand(UnitCommand command) override;
+
+      // Checks a command and predicts its effects, as issueCommand does without sending it. Sets
+      // duplicate if the unit was already given the same command this frame, in which case there
+      // is nothing to send.
+      bool prepareCommand(UnitCommand &command, bool &duplicate);
   };
 }
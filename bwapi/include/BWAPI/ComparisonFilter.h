@@ -6,20 +6,112 @@
 
 #include <functional>
 #include <limits>
+#include <type_traits>
 
 #include "UnaryFilter.h"
 
-#define BWAPI_COMPARE_FILTER_OP(op) UnaryFilter<PType> operator op(const RType &cmp) const               \
-                                    {   return [=](PType v)->bool{ return (*this)(v) op cmp; };   }
+#define BWAPI_COMPARE_FILTER_OP(op,fn) UnaryFilter<PType,CompareFilterCompare<PType,RType,CompareFilter,fn<RType> > > operator op(const RType &cmp) const \
+                                       {   return CompareFilterCompare<PType,RType,CompareFilter,fn<RType> >(*this, cmp);   }
 
-#define BWAPI_ARITHMATIC_FILTER_OP(op) template <typename T>                                            \
-                                       CompareFilter<PType,RType,std::function<RType(PType)> > operator op(const T &other) const     \
-                                       {   return [=](PType v)->int{ return (*this)(v) op other(v); };   }    \
-                                       CompareFilter<PType,RType,std::function<RType(PType)> > operator op(RType other) const     \
-                                       {   return [=](PType v)->int{ return (*this)(v) op other; };   }
+#define BWAPI_ARITHMATIC_FILTER_OP(op,fn) template <typename T>                                            \
+                                          CompareFilter<PType,RType,CompareFilterArithmetic<PType,RType,CompareFilter,typename std::decay<T>::type,fn<RType> > > operator op(const T &other) const     \
+                                          {   return CompareFilterArithmetic<PType,RType,CompareFilter,typename std::decay<T>::type,fn<RType> >(*this, other);   }    \
+                                          CompareFilter<PType,RType,CompareFilterArithmetic<PType,RType,CompareFilter,CompareFilterConstant<PType,RType>,fn<RType> > > operator op(RType other) const     \
+                                          {   return CompareFilterArithmetic<PType,RType,CompareFilter,CompareFilterConstant<PType,RType>,fn<RType> >(*this, other);   }
 
 namespace BWAPI
 {
+  /// Function objects created by CompareFilter's operators. Like the UnaryFilter ones, they store
+  /// their operands by value so that a whole expression such as (HP + Shields < 50) compiles
+  /// into a single inlinable type.
+  template <class PType, class RType, class F, class Op>
+  class CompareFilterCompare
+  {
+  private:
+    F filter;
+    RType cmp;
+  public:
+    CompareFilterCompare(const F &f, const RType &c) : filter(f), cmp(c) {}
+    inline bool operator()(PType v) const
+    {
+      return Op()(filter(v), cmp);
+    };
+    // Used by isValid
+    inline operator bool() const
+    {
+      return true;
+    };
+  };
+
+  template <class PType, class RType>
+  class CompareFilterConstant
+  {
+  private:
+    RType value;
+  public:
+    CompareFilterConstant(const RType &val) : value(val) {}
+    inline RType operator()(PType) const
+    {
+      return value;
+    };
+  };
+
+  template <class PType, class RType, class L, class R, class Op>
+  class CompareFilterArithmetic
+  {
+  private:
+    L lhs;
+    R rhs;
+  public:
+    CompareFilterArithmetic(const L &l, const R &r) : lhs(l), rhs(r) {}
+    inline RType operator()(PType v) const
+    {
+      return Op()(lhs(v), rhs(v));
+    };
+    inline operator bool() const
+    {
+      return true;
+    };
+  };
+
+  template <class PType, class RType, class L, class R>
+  class CompareFilterDivide
+  {
+  private:
+    L lhs;
+    R rhs;
+  public:
+    CompareFilterDivide(const L &l, const R &r) : lhs(l), rhs(r) {}
+    inline RType operator()(PType v) const
+    {
+      int rval = rhs(v);
+      return rval == 0 ? std::numeric_limits<int>::max() : lhs(v) / rval;
+    };
+    inline operator bool() const
+    {
+      return true;
+    };
+  };
+
+  template <class PType, class RType, class L, class R>
+  class CompareFilterModulus
+  {
+  private:
+    L lhs;
+    R rhs;
+  public:
+    CompareFilterModulus(const L &l, const R &r) : lhs(l), rhs(r) {}
+    inline RType operator()(PType v) const
+    {
+      int rval = rhs(v);
+      return rval == 0 ? 0 : lhs(v) % rval;
+    };
+    inline operator bool() const
+    {
+      return true;
+    };
+  };
+
   /// The CompareFilter is a container in which a stored function predicate returns a value.
   /// Arithmetic and bitwise operators will return a new CompareFilter that applies the operation
   /// to the result of the original functor. If any relational operators are used, then it creates
@@ -44,37 +136,33 @@ namespace BWAPI
     // Default copy/move ctor/assign and dtor
 
     // Comparison operators
-    BWAPI_COMPARE_FILTER_OP(==);
-    BWAPI_COMPARE_FILTER_OP(!=);
-    BWAPI_COMPARE_FILTER_OP(<=);
-    BWAPI_COMPARE_FILTER_OP(>=);
-    BWAPI_COMPARE_FILTER_OP(<);
-    BWAPI_COMPARE_FILTER_OP(>);
+    BWAPI_COMPARE_FILTER_OP(==, std::equal_to);
+    BWAPI_COMPARE_FILTER_OP(!=, std::not_equal_to);
+    BWAPI_COMPARE_FILTER_OP(<=, std::less_equal);
+    BWAPI_COMPARE_FILTER_OP(>=, std::greater_equal);
+    BWAPI_COMPARE_FILTER_OP(<,  std::less);
+    BWAPI_COMPARE_FILTER_OP(>,  std::greater);
 
     // Arithmetic operators
-    BWAPI_ARITHMATIC_FILTER_OP(+);
-    BWAPI_ARITHMATIC_FILTER_OP(-);
-    BWAPI_ARITHMATIC_FILTER_OP(|);
-    BWAPI_ARITHMATIC_FILTER_OP(&);
-    BWAPI_ARITHMATIC_FILTER_OP(*);
-    BWAPI_ARITHMATIC_FILTER_OP(^);
+    BWAPI_ARITHMATIC_FILTER_OP(+, std::plus);
+    BWAPI_ARITHMATIC_FILTER_OP(-, std::minus);
+    BWAPI_ARITHMATIC_FILTER_OP(|, std::bit_or);
+    BWAPI_ARITHMATIC_FILTER_OP(&, std::bit_and);
+    BWAPI_ARITHMATIC_FILTER_OP(*, std::multiplies);
+    BWAPI_ARITHMATIC_FILTER_OP(^, std::bit_xor);
 
     // Division
     template <typename T>
-    CompareFilter<PType,RType,std::function<RType(PType)> > operator /(const T &other) const
+    CompareFilter<PType,RType,CompareFilterDivide<PType,RType,CompareFilter,typename std::decay<T>::type> > operator /(const T &other) const
     {   
-      return [=](PType v)->int{ int rval = other(v);
-                                 return rval == 0 ? std::numeric_limits<int>::max() : (*this)(v) / rval;
-                               };
+      return CompareFilterDivide<PType,RType,CompareFilter,typename std::decay<T>::type>(*this, other);
     };
 
     // Modulus
     template <typename T>
-    CompareFilter<PType,RType,std::function<RType(PType)> > operator %(const T &other) const
+    CompareFilter<PType,RType,CompareFilterModulus<PType,RType,CompareFilter,typename std::decay<T>::type> > operator %(const T &other) const
     {   
-      return [=](PType v)->int{ int rval = other(v);
-                                 return rval == 0 ? 0 : (*this)(v) % rval;
-                               };
+      return CompareFilterModulus<PType,RType,CompareFilter,typename std::decay<T>::type>(*this, other);
     };
 
     // call
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+
+namespace BWAPI
+{
+  /// Tag type used to construct a Vectorset whose memory is taken from the FrameArena instead of
+  /// the heap.
+  ///
+  /// @see FrameUnitset
+  struct FrameScoped {};
+
+  /// The FrameArena is a bump allocator for temporary containers that only live for the current
+  /// frame. Allocating from it is a pointer increment, and nothing is freed individually.
+  /// Instead, all of its memory is reclaimed at once when it is reset at the start of the next
+  /// frame.
+  ///
+  /// The arena is reset by Client::update and by BWAPI's own frame update. It also resets
+  /// itself when it sees that the frame count has changed, which covers AI modules that are
+  /// loaded as a DLL.
+  ///
+  /// @warning Memory taken from the arena must not be used after the frame it was allocated in.
+  namespace FrameArena
+  {
+    /// Allocates memory that stays valid until the arena is reset.
+    ///
+    /// @param size
+    ///   The number of bytes to allocate.
+    ///
+    /// @returns A pointer to the memory, or nullptr if the allocation failed.
+    void *allocate(size_t size);
+
+    /// Grows a previous allocation by copying it to a new block of memory. The old block is
+    /// reclaimed on the next reset.
+    ///
+    /// @param ptr
+    ///   The previous allocation, or nullptr.
+    /// @param oldSize
+    ///   The size of the previous allocation, in bytes.
+    /// @param newSize
+    ///   The required size, in bytes.
+    ///
+    /// @returns A pointer to the new memory, or nullptr if the allocation failed.
+    void *reallocate(void *ptr, size_t oldSize, size_t newSize);
+
+    /// Reclaims all of the memory allocated since the last reset. The memory blocks are kept
+    /// for the next frame.
+    void reset();
+
+    /// Retrieves the number of allocations served by the arena since the counters were reset.
+    int getArenaAllocations();
+
+    /// Retrieves the number of bytes served by the arena since the counters were reset.
+    size_t getArenaBytes();
+
+    /// Retrieves the number of heap allocations made by Vectorsets (such as Unitset) since the
+    /// counters were reset. Comparing this with getArenaAllocations shows how many heap
+    /// allocations the arena saved.
+    int getHeapAllocations();
+
+    /// Retrieves the total size of the memory blocks currently owned by the arena, in bytes.
+    size_t getCapacity();
+
+    /// Sets all of the allocation counters to 0.
+    void resetCounters();
+
+    /// Used by Vectorset to count its heap allocations.
+    void countHeapAllocation();
+  }
+}
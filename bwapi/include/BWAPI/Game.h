@@ -1,6 +1,7 @@
 #pragma once
 #include <list>
 #include <string>
+#include <vector>
 
 #include <BWAPI/Interface.h>
 #include <BWAPI/UnitType.h>
@@ -11,6 +12,7 @@
 #include <BWAPI/UnaryFilter.h>
 #include <BWAPI/Input.h>
 #include <BWAPI/CoordinateType.h>
+#include <BWAPI/TileChange.h>
 
 #include <sstream>
 
@@ -45,7 +47,18 @@ namespace BWAPI
   {
   protected:
     virtual ~Game() {};
+
+    /// Passes a unit found by visitUnitsInRectangle on to the function object that was given to
+    /// forEachUnitInRectangle or forEachUnitInRadius.
+    template <typename F>
+    static void callUnitVisitor(const void *visit, Unit unit)
+    {
+      (*static_cast<const F*>(visit))(unit);
+    }
   public :
+    /// The type of function that visitUnitsInRectangle calls for each unit it finds.
+    typedef void (*UnitVisitor)(const void *context, Unit unit);
+
     /// Retrieves the set of all teams/forces. Forces are commonly seen in @UMS game types and
     /// some others such as @TvB and the team versions of game types.
     ///
@@ -343,6 +356,57 @@ namespace BWAPI
     /// @overload
     Unitset getUnitsInRadius(BWAPI::Position center, int radius, const UnitFilter &pred = nullptr) const;
 
+    /// Calls a function for each accessible unit that is in a given rectangle. Unlike
+    /// getUnitsInRectangle, no Unitset is built, so the query does not allocate anything.
+    ///
+    /// @param left
+    ///   The X coordinate of the left position of the bounding box, in pixels.
+    /// @param top
+    ///   The Y coordinate of the top position of the bounding box, in pixels.
+    /// @param right
+    ///   The X coordinate of the right position of the bounding box, in pixels.
+    /// @param bottom
+    ///   The Y coordinate of the bottom position of the bounding box, in pixels.
+    /// @param visit
+    ///   A function object taking a Unit, which is called once for every unit that has any part
+    ///   of it within the given rectangle bounds.
+    ///
+    /// @see getUnitsInRectangle
+    template <typename F>
+    void forEachUnitInRectangle(int left, int top, int right, int bottom, const F &visit) const
+    {
+      this->visitUnitsInRectangle(left, top, right, bottom, &Game::callUnitVisitor<F>, &visit);
+    }
+
+    /// Calls a function for each accessible unit that is within a given radius of a position.
+    /// Unlike getUnitsInRadius, no Unitset is built, so the query does not allocate anything.
+    ///
+    /// @param center
+    ///   The center position, in pixels.
+    /// @param radius
+    ///   The radius from the center, in pixels, to include units.
+    /// @param visit
+    ///   A function object taking a Unit, which is called once for every unit that has any part
+    ///   of it within the given radius from the center position.
+    ///
+    /// @see getUnitsInRadius
+    template <typename F>
+    void forEachUnitInRadius(Position center, int radius, const F &visit) const
+    {
+      this->visitUnitsInRadius(center, radius, &Game::callUnitVisitor<F>, &visit);
+    }
+
+    /// The non-template form of forEachUnitInRectangle. Calls visit with context for every unit
+    /// that has any part of it within the given rectangle bounds.
+    ///
+    /// @see forEachUnitInRectangle
+    virtual void visitUnitsInRectangle(int left, int top, int right, int bottom, UnitVisitor visit, const void *context) const = 0;
+
+    /// The non-template form of forEachUnitInRadius.
+    ///
+    /// @see forEachUnitInRadius
+    void visitUnitsInRadius(Position center, int radius, UnitVisitor visit, const void *context) const;
+
     /// Retrieves the closest unit to center that matches the criteria of the callback pred within
     /// an optional radius.
     ///
@@ -360,6 +424,48 @@ namespace BWAPI
     /// @see getBestUnit, UnitFilter
     Unit getClosestUnit(Position center, const UnitFilter &pred = nullptr, int radius = 999999) const;
 
+    /// Retrieves the k closest units to center that match the criteria of the callback pred
+    /// within an optional radius. The units are only searched once, so this is much faster than
+    /// calling getClosestUnit repeatedly.
+    ///
+    /// @param center
+    ///   The position to start searching for the closest units.
+    /// @param k
+    ///   The maximum number of units to retrieve.
+    /// @param pred (optional)
+    ///   The UnitFilter predicate to determine which units should be included. This includes
+    ///   all units by default.
+    /// @param radius (optional)
+    ///   The radius to search in. If omitted, the entire map will be searched.
+    ///
+    /// @returns A Unitset containing up to k units, ordered from the closest to the farthest.
+    ///
+    /// @see getClosestUnit, UnitFilter
+    Unitset getClosestUnits(Position center, int k, const UnitFilter &pred = nullptr, int radius = 999999) const;
+
+    /// Retrieves the k closest units to each unit in sources that match the criteria of the
+    /// callback pred within an optional radius. All of the sources are answered with a single
+    /// search, and pred is only evaluated once for each unit. The matching units are then
+    /// bucketed on a grid, so each source only measures its distance to the units around it.
+    ///
+    /// @param sources
+    ///   The units to find the closest units for. A source unit is never included in its own
+    ///   results.
+    /// @param k
+    ///   The maximum number of units to retrieve for each source.
+    /// @param pred (optional)
+    ///   The UnitFilter predicate to determine which units should be included. This includes
+    ///   all units by default.
+    /// @param radius (optional)
+    ///   The radius to search in around each source. If omitted, the entire map will be searched.
+    ///
+    /// @returns A vector with one Unitset for each unit in sources, in the same order as sources.
+    /// Each Unitset contains up to k units, ordered from the closest to the farthest. Sources that
+    /// do not exist get an empty Unitset.
+    ///
+    /// @see UnitInterface::getClosestUnit, UnitFilter
+    std::vector<Unitset> getClosestUnits(const Unitset &sources, int k, const UnitFilter &pred = nullptr, int radius = 999999) const;
+
     /// Retrieves the closest unit to center that matches the criteria of the callback pred within
     /// an optional rectangle.
     ///
@@ -480,6 +586,24 @@ namespace BWAPI
     /// @overload
     bool isWalkable(BWAPI::WalkPosition position) const;
 
+    /// Retrieves the clearance of a mini-tile, which is the number of mini-tiles to the nearest
+    /// unwalkable mini-tile or the edge of the map, counting diagonal steps as one. Unwalkable
+    /// mini-tiles have a clearance of 0 and walkable mini-tiles that touch them have 1. The
+    /// clearance of every mini-tile is computed once at the start of the match.
+    ///
+    /// @param walkX
+    ///   The x coordinate of the mini-tile, in mini-tile units (8 pixels).
+    /// @param walkY
+    ///   The y coordinate of the mini-tile, in mini-tile units (8 pixels).
+    ///
+    /// @returns The clearance of the mini-tile, up to 255. Positions outside of the map have a
+    /// clearance of 0.
+    ///
+    /// @see isWalkable
+    virtual int getClearance(int walkX, int walkY) const = 0;
+    /// @overload
+    int getClearance(BWAPI::WalkPosition position) const;
+
     /// Returns the ground height at the given tile position.
     ///
     /// @param tileX
@@ -562,6 +686,81 @@ namespace BWAPI
     /// @overload
     bool hasCreep(TilePosition position) const;
 
+    /// Checks if any tile in the given rectangle is visible to the current player. This is much
+    /// faster than calling isVisible for each tile, since the client tests 64 tiles at a time.
+    ///
+    /// @param tileLeft
+    ///   The left edge of the rectangle, in tiles.
+    /// @param tileTop
+    ///   The top edge of the rectangle, in tiles.
+    /// @param tileRight
+    ///   The right edge of the rectangle, in tiles. This tile is included.
+    /// @param tileBottom
+    ///   The bottom edge of the rectangle, in tiles. This tile is included.
+    ///
+    /// @returns true if at least one tile in the rectangle is visible, and false otherwise. The
+    /// part of the rectangle that is outside of the map is ignored.
+    ///
+    /// @see isVisible
+    virtual bool isAnyVisible(int tileLeft, int tileTop, int tileRight, int tileBottom) const = 0;
+    /// @overload
+    bool isAnyVisible(TilePosition topLeft, TilePosition bottomRight) const;
+
+    /// Checks if every tile in the given rectangle has been explored by the player.
+    ///
+    /// @param tileLeft
+    ///   The left edge of the rectangle, in tiles.
+    /// @param tileTop
+    ///   The top edge of the rectangle, in tiles.
+    /// @param tileRight
+    ///   The right edge of the rectangle, in tiles. This tile is included.
+    /// @param tileBottom
+    ///   The bottom edge of the rectangle, in tiles. This tile is included.
+    ///
+    /// @returns true if all tiles in the rectangle have been explored, and false otherwise. The
+    /// part of the rectangle that is outside of the map is ignored.
+    ///
+    /// @see isExplored
+    virtual bool isAllExplored(int tileLeft, int tileTop, int tileRight, int tileBottom) const = 0;
+    /// @overload
+    bool isAllExplored(TilePosition topLeft, TilePosition bottomRight) const;
+
+    /// Checks if any tile in the given rectangle has @Zerg creep on it.
+    ///
+    /// @param tileLeft
+    ///   The left edge of the rectangle, in tiles.
+    /// @param tileTop
+    ///   The top edge of the rectangle, in tiles.
+    /// @param tileRight
+    ///   The right edge of the rectangle, in tiles. This tile is included.
+    /// @param tileBottom
+    ///   The bottom edge of the rectangle, in tiles. This tile is included.
+    ///
+    /// @returns true if at least one tile in the rectangle has creep on it, and false otherwise.
+    /// Creep that is concealed by the fog of war is not counted.
+    ///
+    /// @see hasCreep
+    virtual bool hasAnyCreep(int tileLeft, int tileTop, int tileRight, int tileBottom) const = 0;
+    /// @overload
+    bool hasAnyCreep(TilePosition topLeft, TilePosition bottomRight) const;
+
+    /// Retrieves the tiles whose visibility, exploration, creep or occupation by structures
+    /// changed since the previous frame. A bot that keeps its own copy of these layers can
+    /// update only the tiles returned here, instead of checking every tile of the map each frame.
+    ///
+    /// @param tiles
+    ///   The vector that the changed tiles are appended to.
+    /// @param layers (optional)
+    ///   A combination of TileChange::Enum values that selects the layers to report changes
+    ///   for. By default, changes to any of them are reported.
+    ///
+    /// @retval true If \p tiles received exactly the tiles that changed.
+    /// @retval false If too many tiles changed to be listed individually. In this case \p tiles
+    /// received every tile of each 8x8 block that changed in any layer, regardless of \p layers.
+    ///
+    /// @note On the first frame of a match, every tile is reported as changed.
+    virtual bool getChangedTiles(std::vector<TilePosition> &tiles, int layers = TileChange::All) const = 0;
+
     /// Checks if the given pixel position is powered by an owned @Protoss_Pylon for an optional
     /// unit type.
     ///
@@ -1113,6 +1312,51 @@ namespace BWAPI
     /// @overload
     void drawLineScreen(Position a, Position b, Color color);
 
+    /// Creates a persistent draw list, or retrieves the one that already has the given name.
+    /// Shapes drawn between beginDrawList and endDrawList are stored in the list instead of
+    /// being drawn for a single frame, and BWAPI draws them every frame until the list is
+    /// replaced or cleared. Use draw lists for overlays that rarely change, such as base
+    /// locations or region borders, so that they are not sent again every frame.
+    ///
+    /// @param name
+    ///   The name of the draw list.
+    ///
+    /// @returns The handle of the draw list, or -1 if it could not be created. Draw lists are
+    /// removed at the end of a match.
+    ///
+    /// Example usage
+    /// @code
+    ///   void ExampleAIModule::onStart()
+    ///   {
+    ///     // Mark the start locations once for the whole match
+    ///     int startList = BWAPI::Broodwar->createDrawList("start locations");
+    ///     BWAPI::Broodwar->beginDrawList(startList);
+    ///     for ( auto it = BWAPI::Broodwar->getStartLocations().begin(); it != BWAPI::Broodwar->getStartLocations().end(); ++it )
+    ///       BWAPI::Broodwar->drawBoxMap(BWAPI::Position(*it), BWAPI::Position(*it + BWAPI::TilePosition(4, 3)), BWAPI::Colors::Blue);
+    ///     BWAPI::Broodwar->endDrawList();
+    ///   }
+    /// @endcode
+    /// @see beginDrawList, clearDrawList
+    virtual int createDrawList(const char *name) = 0;
+
+    /// Replaces the contents of a draw list with the shapes drawn from now until endDrawList is
+    /// called. Shapes are recorded even if they are not on the screen at the moment.
+    ///
+    /// @param list
+    ///   The handle of the draw list, as returned by createDrawList.
+    virtual void beginDrawList(int list) = 0;
+
+    /// Stops recording shapes into the draw list given to beginDrawList. Shapes drawn after this
+    /// call are drawn for the current frame only.
+    virtual void endDrawList() = 0;
+
+    /// Removes all shapes from a draw list. The handle stays valid and the list can be filled
+    /// again with beginDrawList.
+    ///
+    /// @param list
+    ///   The handle of the draw list, as returned by createDrawList.
+    virtual void clearDrawList(int list) = 0;
+
     /// Retrieves the maximum delay, in number of frames, between a command being issued and the
     /// command being executed by Broodwar.
     ///
@@ -1259,6 +1503,29 @@ namespace BWAPI
     /// @retval false if there is no path
     virtual bool hasPath(Position source, Position destination) const = 0;
 
+    /// Checks if a unit of the given size can travel from source to destination. In addition to
+    /// the connectivity check of the regular hasPath, this requires a path of mini-tiles whose
+    /// clearance is at least 1, 2 or 3 for @Small, @Medium and @Large units, so that narrow gaps
+    /// that only smaller units fit through are taken into account.
+    ///
+    /// The clearance requirements approximate the unit dimensions of each size class. The
+    /// connected areas for a size class are computed the first time it is queried and kept for
+    /// the rest of the match.
+    ///
+    /// @param source
+    ///   The source position.
+    /// @param destination
+    ///   The destination position.
+    /// @param size
+    ///   The size of the unit that will travel. For any other UnitSizeType, this is the same as
+    ///   the regular hasPath.
+    ///
+    /// @retval true if there is a path between the two positions for the given size
+    /// @retval false if there is no path
+    ///
+    /// @see getClearance
+    virtual bool hasPath(Position source, Position destination, UnitSizeType size) const = 0;
+
     /// Sets the alliance state of the current player with the target player.
     ///
     /// @param player
@@ -1420,6 +1687,39 @@ namespace BWAPI
     /// @overload
     BWAPI::Region getRegionAt(BWAPI::Position position) const;
 
+    /// Retrieves the ground distance between two regions. This is the length of the shortest path
+    /// from the center of \p source to the center of \p destination through neighboring accessible
+    /// regions, where each step is the distance between the centers of two neighbors.
+    ///
+    /// The shortest paths from a region are computed the first time that region is used as a
+    /// source, and are kept for the rest of the match. Any further queries from the same source
+    /// are a table lookup.
+    ///
+    /// @param source
+    ///   The Region to start from.
+    /// @param destination
+    ///   The Region to reach.
+    ///
+    /// @returns The ground distance in pixels, or -1 if there is no ground path between the two
+    /// regions.
+    ///
+    /// @see Region::getDistance
+    virtual int getGroundDistance(BWAPI::Region source, BWAPI::Region destination) const = 0;
+
+    /// Retrieves the approximate ground distance between two positions. If both positions are in
+    /// the same region, this is the direct distance between them. Otherwise it is the distance to
+    /// the center of the source's region, the ground distance between the two regions, and the
+    /// distance from the center of the destination's region.
+    ///
+    /// @param source
+    ///   The position to start from, in pixels.
+    /// @param destination
+    ///   The position to reach, in pixels.
+    ///
+    /// @returns The approximate ground distance in pixels, or -1 if there is no ground path
+    /// between the two positions.
+    int getGroundDistance(BWAPI::Position source, BWAPI::Position destination) const;
+
     /// Retrieves the amount of time (in milliseconds) that has elapsed when running the last AI
     /// module callback. This is used by tournament modules to penalize AI modules that use too
     /// much processing time.
@@ -0,0 +1,111 @@
+#pragma once
+#include <BWAPI/Unitset.h>
+#include <vector>
+
+namespace BWAPI
+{
+  /// The IndexedUnitset is a Unitset that also remembers where each unit is stored, indexed by
+  /// the unit's ID. Checking, inserting and erasing a unit take constant time instead of a scan
+  /// of the whole set, and the set operations with another set are linear in the size of the
+  /// other set.
+  ///
+  /// It is intended for sets that are updated a few units at a time, such as the set of units
+  /// owned by a player. The order of the units is not preserved.
+  ///
+  /// @note Units that do not have an ID yet (getID returns -1) are stored without an index and
+  /// fall back to a linear search.
+  ///
+  /// @see Unitset
+  class IndexedUnitset
+  {
+  public:
+    typedef Unitset::iterator iterator;
+
+    IndexedUnitset(size_t initialSize = 16);
+
+    /// Retrieves the units as a regular Unitset. The reference stays valid for the lifetime of
+    /// the IndexedUnitset.
+    inline const Unitset &getUnits() const
+    {
+      return units;
+    };
+    /// @copydoc getUnits
+    inline operator const Unitset &() const
+    {
+      return units;
+    };
+
+    inline iterator begin() const
+    {
+      return units.begin();
+    };
+    inline iterator end() const
+    {
+      return units.end();
+    };
+    inline size_t size() const
+    {
+      return units.size();
+    };
+    inline bool empty() const
+    {
+      return units.empty();
+    };
+
+    /// Checks if a unit is in the set.
+    ///
+    /// @param u
+    ///   The unit to look for.
+    ///
+    /// @returns true if u is in the set, and false otherwise.
+    bool contains(Unit u) const;
+
+    /// Inserts a unit if it is not already in the set.
+    ///
+    /// @param u
+    ///   The unit to insert.
+    ///
+    /// @returns true if u was inserted, and false if it was already in the set.
+    bool insert(Unit u);
+
+    /// Inserts a unit. Duplicates are never stored, so this is the same as insert.
+    inline void push_back(Unit u)
+    {
+      this->insert(u);
+    };
+
+    /// Erases a unit from the set.
+    ///
+    /// @param u
+    ///   The unit to erase.
+    ///
+    /// @returns true if u was erased, and false if it was not in the set.
+    bool erase(Unit u);
+
+    /// Removes all units from the set.
+    void clear();
+
+    /// Replaces the contents of this set with the units in other.
+    IndexedUnitset &operator =(const Unitset &other);
+
+    /// Inserts every unit of other that is not already in this set.
+    IndexedUnitset &operator |=(const Unitset &other);
+    /// Keeps only the units that are also in other.
+    IndexedUnitset &operator &=(const Unitset &other);
+    /// Erases every unit of other from this set.
+    IndexedUnitset &operator -=(const Unitset &other);
+
+    /// Creates a Unitset containing the units of both this set and other, without duplicates.
+    Unitset operator |(const Unitset &other) const;
+    /// Creates a Unitset containing the units of other that are also in this set.
+    Unitset operator &(const Unitset &other) const;
+    /// Creates a Unitset containing the units of this set that are not in other.
+    Unitset operator -(const Unitset &other) const;
+  private:
+    // Position of the unit with the given ID in units plus one, or 0 if it is not in the set
+    int slotOf(int id) const;
+
+    Unitset units;
+    std::vector<int> slots;
+  };
+}
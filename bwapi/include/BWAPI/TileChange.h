@@ -0,0 +1,24 @@
+#pragma once
+namespace BWAPI
+{
+  namespace TileChange
+  {
+    /** The tile layers that Game::getChangedTiles reports changes for. The values can be combined. */
+    enum Enum
+    {
+      /** The tile became visible or was concealed by the fog of war. */
+      Visible  = 1,
+
+      /** The tile was explored for the first time. */
+      Explored = 2,
+
+      /** Creep appeared on or receded from the tile. */
+      Creep    = 4,
+
+      /** A structure was placed on, removed from, lifted off or landed on the tile. */
+      Occupied = 8,
+
+      All      = Visible | Explored | Creep | Occupied
+    };
+  }
+}
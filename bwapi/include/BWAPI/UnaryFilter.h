@@ -1,8 +1,67 @@
 #pragma once
 #include <functional>
+#include <type_traits>
 
 namespace BWAPI
 {
+  /// Function objects created by UnaryFilter's logical operators. The operands are stored by
+  /// value, so a combined filter such as (IsWorker && IsIdle) is a single concrete type that the
+  /// compiler can inline, instead of a chain of std::function calls.
+  template <class PType, class L, class R>
+  class UnaryFilterAnd
+  {
+  private:
+    L lhs;
+    R rhs;
+  public:
+    UnaryFilterAnd(const L &l, const R &r) : lhs(l), rhs(r) {}
+    inline bool operator()(PType v) const
+    {
+      return lhs(v) && rhs(v);
+    };
+    // Used by UnaryFilter::isValid
+    inline operator bool() const
+    {
+      return true;
+    };
+  };
+
+  template <class PType, class L, class R>
+  class UnaryFilterOr
+  {
+  private:
+    L lhs;
+    R rhs;
+  public:
+    UnaryFilterOr(const L &l, const R &r) : lhs(l), rhs(r) {}
+    inline bool operator()(PType v) const
+    {
+      return lhs(v) || rhs(v);
+    };
+    inline operator bool() const
+    {
+      return true;
+    };
+  };
+
+  template <class PType, class F>
+  class UnaryFilterNot
+  {
+  private:
+    F filter;
+  public:
+    UnaryFilterNot(const F &f) : filter(f) {}
+    inline bool operator()(PType v) const
+    {
+      return !filter(v);
+    };
+    // The negation of an empty filter is also empty
+    inline operator bool() const
+    {
+      return filter.isValid();
+    };
+  };
+
   /// UnaryFilter allows for logical functor combinations.
   ///
   /// @code
@@ -15,6 +74,16 @@ namespace BWAPI
   ///   {}
   /// @endcode
   ///
+  /// Breaking change: each combination has its own type, so a filter that is built up over
+  /// several statements must be stored in a UnitFilter rather than declared with auto.
+  /// `auto f = IsWorker && IsCompleted; f = f && IsIdle;` compiled when every operator returned a
+  /// UnitFilter, and now stops at the static_assert in the converting constructor.
+  /// @code
+  ///   UnitFilter f = IsWorker && IsCompleted;
+  ///   if ( onlyIdle )
+  ///     f = f && IsIdle;
+  /// @endcode
+  ///
   /// @tparam PType
   ///   The type being passed into the predicate, which will be of type bool(PType).
   /// @tparam Container (optional)
@@ -29,26 +98,34 @@ namespace BWAPI
     template < typename T >
     UnaryFilter(const T &predicate) : pred(predicate) {}
 
+    // Converting from another kind of UnaryFilter keeps an empty filter empty
+    template < class C >
+    UnaryFilter(const UnaryFilter<PType,C> &other) : pred(other.isValid() ? Container(other) : Container())
+    {
+      static_assert(std::is_convertible<const UnaryFilter<PType,C>&, Container>::value,
+                    "A combined filter cannot be assigned another combination, store it in a UnitFilter instead of auto");
+    }
+
     // Default copy/move ctor/assign and dtor
     
     // logical operators
+    // The results keep their own copies of both operands, and convert to any other UnaryFilter
+    // (such as UnitFilter) when they need to be stored.
     template <typename T>
-    inline UnaryFilter<PType,std::function<bool(PType)> > operator &&(const T& other) const
+    inline UnaryFilter<PType,UnaryFilterAnd<PType,UnaryFilter,typename std::decay<T>::type> > operator &&(const T& other) const
     {
-      return [=](PType v){ return (*this)(v) && other(v); };
+      return UnaryFilterAnd<PType,UnaryFilter,typename std::decay<T>::type>(*this, other);
     };
 
     template <typename T>
-    inline UnaryFilter<PType,std::function<bool(PType)> > operator ||(const T& other) const
+    inline UnaryFilter<PType,UnaryFilterOr<PType,UnaryFilter,typename std::decay<T>::type> > operator ||(const T& other) const
     {
-      return [=](PType v){ return (*this)(v) || other(v); };
+      return UnaryFilterOr<PType,UnaryFilter,typename std::decay<T>::type>(*this, other);
     };
 
-    inline UnaryFilter<PType,std::function<bool(PType)> > operator !() const
+    inline UnaryFilter<PType,UnaryFilterNot<PType,UnaryFilter> > operator !() const
     {
-      if ( !this->pred )
-        return nullptr;
-      return [=](PType v){ return !(*this)(v); };
+      return UnaryFilterNot<PType,UnaryFilter>(*this);
     };
 
     // call
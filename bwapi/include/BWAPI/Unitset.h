@@ -186,6 +186,41 @@ namespace BWAPI
     
     /// @copydoc UnitInterface::useTech
     bool useTech(TechType tech, PositionOrUnit target = nullptr) const;
+  protected:
+    /// Constructors used by FrameUnitset.
+    Unitset(size_t initialSize, const FrameScoped &tag);
+    Unitset(Unitset &&other, const FrameScoped &tag);
+  };
+
+  /// The FrameUnitset is a Unitset that takes its memory from the FrameArena instead of the
+  /// heap. It is meant for temporary sets that are built and thrown away within a frame, where
+  /// the heap allocations of a regular Unitset would add up.
+  ///
+  /// @code
+  ///   FrameUnitset nearby;
+  ///   Broodwar->forEachUnitInRadius(pos, 256, [&](Unit u){ nearby.push_back(u); });
+  /// @endcode
+  ///
+  /// @warning A FrameUnitset must not be used after the frame it was created in. Copying or
+  /// moving it into a regular Unitset makes a copy on the heap, which can be kept.
+  ///
+  /// @see FrameArena
+  class FrameUnitset : public Unitset
+  {
+  public:
+    /// Creates an empty FrameUnitset.
+    ///
+    /// @param initialSize The initial maximum size of the FrameUnitset before expanding it is
+    /// necessary.
+    FrameUnitset(size_t initialSize = 16);
+
+    /// Creates a FrameUnitset containing a copy of the units in other.
+    FrameUnitset(const ConstVectorset<Unit> &other);
+    /// @overload
+    FrameUnitset(const FrameUnitset &other);
+
+    /// The move constructor.
+    FrameUnitset(FrameUnitset &&other);
   };
 }
 
@@ -5,6 +5,7 @@
 
 #include "Vectorset_iterator.h"
 #include "ConstVectorset.h"
+#include "FrameArena.h"
 
 namespace BWAPI
 {
@@ -32,8 +33,22 @@ namespace BWAPI
     /// @param initialSize
     ///   The number of elements of type _T to allocate memory for.
     Vectorset(size_t initialSize = 16)
-      : ConstVectorset<_T>( (_T*)malloc(initialSize*sizeof(_T)) )
+      : ConstVectorset<_T>( allocate(initialSize, false) )
       , pEndAlloc( ConstVectorset<_T>::pStartArr + initialSize )
+      , frameScoped(false)
+    {};
+
+    /// This constructor creates a Vectorset that takes its memory from the FrameArena. It can
+    /// only be used until the end of the current frame.
+    ///
+    /// @param initialSize
+    ///   The number of elements of type _T to allocate memory for.
+    ///
+    /// @see FrameArena
+    Vectorset(size_t initialSize, const FrameScoped &)
+      : ConstVectorset<_T>( allocate(initialSize, true) )
+      , pEndAlloc( ConstVectorset<_T>::pStartArr + initialSize )
+      , frameScoped(true)
     {};
     
     /// This is the copy constructor. The Vectorset will allocate only the necessary space to
@@ -44,15 +59,17 @@ namespace BWAPI
     ///
     /// @note Duplicate entries are not removed.
     Vectorset(const Vectorset<_T> &other)
-      : ConstVectorset<_T>( (_T*)malloc( other.size()*sizeof(_T)), other.size() )
+      : ConstVectorset<_T>( allocate(other.size(), false), other.size() )
       , pEndAlloc( ConstVectorset<_T>::pEndArr )
+      , frameScoped(false)
     { 
       memcpy(this->pStartArr, (void*)other, other.size()*sizeof(_T));
     };
     /// @overload
     Vectorset(const ConstVectorset<_T> &other)
-      : ConstVectorset<_T>( (_T*)malloc( other.size()*sizeof(_T)), other.size() )
+      : ConstVectorset<_T>( allocate(other.size(), false), other.size() )
       , pEndAlloc( ConstVectorset<_T>::pEndArr )
+      , frameScoped(false)
     { 
       memcpy(this->pStartArr, (void*)other, other.size()*sizeof(_T));
     };
@@ -64,9 +81,25 @@ namespace BWAPI
     ///   Reference to the Vectorset of the same type whose contents will be moved.
     ///
     /// @note Duplicate entries are not removed.
+    /// @note A Vectorset that uses the FrameArena is copied instead, so that the new Vectorset
+    /// remains valid after the current frame.
     Vectorset(Vectorset<_T> &&other)
+      : ConstVectorset<_T>( other.frameScoped ? allocate(other.size(), false) : other.pStartArr, other.size() )
+      , pEndAlloc( other.frameScoped ? ConstVectorset<_T>::pEndArr : other.pEndAlloc )
+      , frameScoped(false)
+    { 
+      if ( other.frameScoped )
+        memcpy(this->pStartArr, (void*)other, other.size()*sizeof(_T));
+      else
+        other.pStartArr = nullptr;
+    };
+
+    /// This is the move constructor for Vectorsets that use the FrameArena. The data pointer is
+    /// stolen from the other Vectorset, which must also use the FrameArena.
+    Vectorset(Vectorset<_T> &&other, const FrameScoped &)
       : ConstVectorset<_T>( other.pStartArr, other.size() )
       , pEndAlloc( other.pEndAlloc )
+      , frameScoped(true)
     { 
       other.pStartArr = nullptr;
     };
@@ -81,8 +114,9 @@ namespace BWAPI
     ///
     /// @note Duplicate entries are not removed.
     Vectorset(const _T *pArray, size_t arrSize)
-      : ConstVectorset<_T>( (_T*)malloc(arrSize*sizeof(_T)), arrSize )
+      : ConstVectorset<_T>( allocate(arrSize, false), arrSize )
       , pEndAlloc( ConstVectorset<_T>::pEndArr )
+      , frameScoped(false)
     {
       memcpy(this->pStartArr, pArray, arrSize*sizeof(_T) );
     };
@@ -92,7 +126,8 @@ namespace BWAPI
     {
       if ( this->pStartArr != nullptr )
       {
-        free(this->pStartArr);
+        if ( !frameScoped )
+          free(this->pStartArr);
         this->pStartArr = nullptr;
       }
     };
@@ -120,7 +155,15 @@ namespace BWAPI
     /// @returns A reference to the current object.
     Vectorset &operator =(Vectorset<_T> &&other)
     {
-      if ( this->pStartArr != nullptr )
+      // Memory can only be stolen if both use the same allocator
+      if ( this->frameScoped != other.frameScoped )
+      {
+        this->clear();
+        this->push_back(other);
+        return *this;
+      }
+
+      if ( this->pStartArr != nullptr && !frameScoped )
         free(this->pStartArr);
       
       this->pStartArr = other.pStartArr;
@@ -501,7 +544,16 @@ namespace BWAPI
       allocSize = ((arrSize + additionalElements)/256 + 1)*256;
 
       // Reallocate and store the new values
-      _T *pReallocated = (_T*)realloc(this->pStartArr, allocSize*sizeof(_T));
+      _T *pReallocated;
+      if ( frameScoped )
+      {
+        pReallocated = (_T*)FrameArena::reallocate(this->pStartArr, this->max_size()*sizeof(_T), allocSize*sizeof(_T));
+      }
+      else
+      {
+        FrameArena::countHeapAllocation();
+        pReallocated = (_T*)realloc(this->pStartArr, allocSize*sizeof(_T));
+      }
       if ( pReallocated != nullptr )
       {
         this->pStartArr  = pReallocated;
@@ -512,8 +564,18 @@ namespace BWAPI
       return false;
     };
 
+    /// Allocates memory for the given number of elements, from the FrameArena or the heap.
+    static _T *allocate(size_t count, bool fromFrameArena)
+    {
+      if ( fromFrameArena )
+        return (_T*)FrameArena::allocate(count*sizeof(_T));
+      FrameArena::countHeapAllocation();
+      return (_T*)malloc(count*sizeof(_T));
+    };
+
     // Variables
     _T *pEndAlloc;    // ptr to end of allocation
+    bool frameScoped; // memory is owned by the FrameArena
   };
 
 }